@@ -0,0 +1,187 @@
+// bench.cpp
+// 各运算在不同位数下的耗时，输出JSON或CSV，便于比较不同版本
+// 用法：my_bigint_bench [--format=json|csv] [--min-digits=N] [--max-digits=N]
+//                       [--max-pi-digits=N] [--min-time=毫秒] [--threads=N]
+//                       [--filter=运算名]
+// 结果输出到标准输出，进度输出到标准错误
+#include "my_bigint.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+struct options {
+  bool csv = false;
+  std::size_t min_digits = 10;
+  std::size_t max_digits = 1'000'000;
+  // PI每项都要做整段除法，总开销O(n^2)，单独限制位数
+  std::size_t max_pi_digits = 20'000;
+  double min_time_ms = 200;
+  std::size_t threads = 1;
+  std::string filter;
+};
+struct result {
+  std::string operation;
+  std::size_t digits;
+  std::size_t iterations;
+  double ns_per_op;
+};
+
+auto parse_options(int argc, char **argv) -> options {
+  options opts;
+  for (int i = 1; i < argc; i++) {
+    // --名称=值
+    const std::string_view arg{argv[i]};
+    const std::size_t eq = arg.find('=');
+    const std::string_view name{arg.substr(0, eq)};
+    const char *value = eq == std::string_view::npos ? "" : argv[i] + eq + 1;
+    if (name == "--format") {
+      opts.csv = std::string_view{value} == "csv";
+    } else if (name == "--min-digits") {
+      opts.min_digits = std::strtoull(value, nullptr, 10);
+    } else if (name == "--max-digits") {
+      opts.max_digits = std::strtoull(value, nullptr, 10);
+    } else if (name == "--max-pi-digits") {
+      opts.max_pi_digits = std::strtoull(value, nullptr, 10);
+    } else if (name == "--min-time") {
+      opts.min_time_ms = std::strtod(value, nullptr);
+    } else if (name == "--threads") {
+      opts.threads = std::strtoull(value, nullptr, 10);
+    } else if (name == "--filter") {
+      opts.filter = value;
+    } else {
+      std::cerr << "unknown option: " << arg << '\n';
+      std::exit(2);
+    }
+  }
+  if (!opts.min_digits)
+    opts.min_digits = 1;
+  return opts;
+}
+
+// 固定种子，每次运行的操作数相同
+auto random_digits(std::mt19937_64 &rng, std::size_t n) -> std::string {
+  std::string digits(n, '0');
+  for (char &c : digits)
+    c = static_cast<char>('0' + rng() % 10);
+  if (digits[0] == '0')
+    digits[0] = '1';
+  return digits;
+}
+
+// 重复执行直到累计时间超过min_time，至少一次
+auto measure(const options &opts, const std::function<void()> &operation)
+    -> std::pair<std::size_t, double> {
+  using clock = std::chrono::steady_clock;
+  std::size_t iterations = 0;
+  const auto start = clock::now();
+  std::chrono::duration<double, std::milli> elapsed{};
+  do {
+    operation();
+    ++iterations;
+    elapsed = clock::now() - start;
+  } while (elapsed.count() < opts.min_time_ms);
+  return {iterations, elapsed.count() * 1e6 / static_cast<double>(iterations)};
+}
+
+// 梅钦公式 pi = 16*arctan(1/5) - 4*arctan(1/239)，与tests/test.cpp中的PI()相同
+auto PI(int N) -> BigInt {
+  const BigInt n{10};
+  N--;
+  const BigInt b{pow(n, static_cast<std::size_t>(N + 10))};
+  BigInt x1{b * 4 / 5}, x2{b / -239};
+  BigInt s{x1 + x2};
+  for (int i = 3; i <= N * 2; i += 2) {
+    x1 /= -25;
+    x2 /= -57121;
+    s += (x1 + x2) / i;
+  }
+  return s * 4 / pow(n, 10);
+}
+
+// 防止编译器把结果优化掉
+volatile std::size_t sink;
+auto keep(const BigInt &x) -> void { sink = x > 0 ? 1 : 0; }
+
+auto run(const options &opts) -> std::vector<result> {
+  std::vector<result> results;
+  std::mt19937_64 rng{20241017};
+  const auto bench = [&](const char *operation, std::size_t digits,
+                         const std::function<void()> &body) {
+    if (!opts.filter.empty() && opts.filter != operation)
+      return;
+    const auto [iterations, ns] = measure(opts, body);
+    results.push_back(result{operation, digits, iterations, ns});
+    std::cerr << operation << ' ' << digits << ": " << ns << " ns\n";
+  };
+
+  for (std::size_t digits = opts.min_digits; digits <= opts.max_digits;
+       digits *= 10) {
+    const std::string text{random_digits(rng, digits)};
+    const BigInt a{text}, b{random_digits(rng, digits)};
+    const BigInt wide{random_digits(rng, 2 * digits)};
+
+    bench("parse", digits, [&] { keep(BigInt{text}); });
+    bench("print", digits, [&] { sink = a.to_string().size(); });
+    bench("add", digits, [&] { keep(a + b); });
+    bench("sub", digits, [&] { keep(a - b); });
+    bench("mul", digits, [&] { keep(a * b); });
+    bench("square", digits, [&] { keep(a.square()); });
+    bench("div_small", digits, [&] { keep(a / 987654321); });
+    // 2n位除以n位，商和除数等长
+    bench("div_big", digits, [&] { keep(wide / a); });
+    bench("gcd", digits, [&] { keep(BigInt::gcd(a, b)); });
+    bench("isqrt", digits, [&] { keep(BigInt::isqrt(a)); });
+    // digits/9个9位数的积约有digits位
+    std::vector<BigInt> factors;
+    for (std::size_t i = 0; i < digits / 9 + 1; i++)
+      factors.emplace_back(random_digits(rng, 9));
+    bench("product", digits, [&] { keep(BigInt::product(factors)); });
+    // 3^e约有digits位
+    const auto exponent = static_cast<std::size_t>(
+        static_cast<double>(digits) / 0.47712125472);
+    bench("pow", digits, [&] { keep(pow(BigInt{3}, exponent)); });
+    if (digits <= opts.max_pi_digits)
+      bench("pi", digits, [&] { keep(PI(static_cast<int>(digits))); });
+  }
+  return results;
+}
+
+auto print_json(const std::vector<result> &results, const options &opts)
+    -> void {
+  std::printf("{\n  \"library\": \"my_bigint\",\n  \"threads\": %zu,\n"
+              "  \"results\": [\n",
+              opts.threads);
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const result &r = results[i];
+    std::printf("    {\"operation\": \"%s\", \"digits\": %zu, "
+                "\"iterations\": %zu, \"ns_per_op\": %.1f}%s\n",
+                r.operation.c_str(), r.digits, r.iterations, r.ns_per_op,
+                i + 1 < results.size() ? "," : "");
+  }
+  std::printf("  ]\n}\n");
+}
+auto print_csv(const std::vector<result> &results) -> void {
+  std::printf("operation,digits,iterations,ns_per_op\n");
+  for (const result &r : results)
+    std::printf("%s,%zu,%zu,%.1f\n", r.operation.c_str(), r.digits,
+                r.iterations, r.ns_per_op);
+}
+} // namespace
+
+auto main(int argc, char **argv) -> int {
+  const options opts{parse_options(argc, argv)};
+  BigInt::set_parallel(opts.threads);
+  const std::vector<result> results{run(opts)};
+  if (opts.csv)
+    print_csv(results);
+  else
+    print_json(results, opts);
+  return 0;
+}
@@ -1,46 +1,93 @@
 // my_bigint.h
 #ifndef MY_BIGINT_H
 #define MY_BIGINT_H
+#include <charconv>
+#include <compare>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#if __has_include(<format>)
+#include <format>
+#endif
 
 // 小端序，裸指针配合数组   效率高于>>智能指针和vector
+// 每个元素(limb)存放一个2^32进制位，乘法中间结果用64位整数保存
 // 接受所有整数类和类string类的参数用于构造
+class BigIntView;
 class BigInt final {
+public:
+  // 一个limb为32位无符号整数，基数为2^32
+  using value_type = std::uint32_t;
+  using size_type = std::size_t;
+  // 两个limb相乘的中间结果类型
+  using wide_type = std::uint64_t;
+  static constexpr int limb_bits = 32;
+
 private:
   // inline static const BigInt zero{"0"};
-  using value_type = std::int_fast8_t;
-  using size_type = std::size_t;
   struct bigInt_division_result;
+  // size_为容量，length_为有效limb个数，0表示为length_==1且array_[0]==0
   size_type size_, length_;
   // 编译器优化前裸指针配合数组效率高于uniqe_ptr和vector，计算20000位pi时，时间差距达到20秒以上
+  // 容量不超过inline_capacity时指向inline_，否则指向resource_分配的数组
   value_type *array_;
   bool negative_{false};
+  // 堆上数组的来源，构造时取当前线程的默认资源，移动构造时沿用源对象的
+  std::pmr::memory_resource *resource_;
+  // 小数字直接存放在对象内，128位以内的运算不分配内存
+  static constexpr size_type inline_capacity = 4;
+  value_type inline_[inline_capacity];
+  [[nodiscard]] auto is_inline() const noexcept -> bool {
+    return array_ == inline_;
+  }
+  // 移动后源对象变为内联存储的0，仍然可以正常使用
+  auto reset_inline() noexcept -> void {
+    size_ = inline_capacity;
+    length_ = 1;
+    array_ = inline_;
+    array_[0] = 0;
+    negative_ = false;
+  }
+  // 用resource_分配n个limb
+  [[nodiscard]] auto allocate(size_type n) const -> value_type *;
+  // 释放堆上数组，内联存储时什么也不做
+  auto deallocate() noexcept -> void;
   auto begin() noexcept -> value_type * { return array_; }
   auto end() noexcept -> value_type * { return array_ + length_; }
-  // 静态根据源整数类型推断数组容量
+  // 静态根据源整数类型推断数组容量(limb个数)
   template <std::integral T>
   [[nodiscard]] static consteval size_type get_initial_size() noexcept;
   // 编译期取得初始哈数据大小
   template <std::integral T>
   static constexpr size_type initial_size = get_initial_size<T>();
 
+  friend class BigIntView;
+
   // 可以手动预分配内存,私有,人工保证_size参数合法性
-  // o(n)，n：初始位数//容量至少为1,初始内容为0
+  // o(n)，n：初始limb数//容量至少能放下initialValue,初始内容为initialValue
   explicit BigInt(std::uintmax_t initialValue, const size_type _size,
                   const bool _negative = false) noexcept;
 
 public:
-  ~BigInt() noexcept { delete[] array_; }
+  ~BigInt() noexcept { deallocate(); }
   BigInt() noexcept : BigInt(0, 1, false) {}
-  // 有符号整型构造
+  // 有符号整型构造，最小值取绝对值时先转为无符号避免溢出
   template <typename T>
     requires std::integral<T> && std::is_signed_v<T>
   explicit BigInt(T initialValue) noexcept
-      : BigInt{static_cast<std::uintmax_t>(std::abs(initialValue)),
+      : BigInt{initialValue < T{0}
+                   ? std::uintmax_t{0} - static_cast<std::uintmax_t>(initialValue)
+                   : static_cast<std::uintmax_t>(initialValue),
                initial_size<T>, initialValue < T{0}} {}
   // 无符号整型构造
   template <typename T>
@@ -48,22 +95,77 @@ public:
   explicit BigInt(T initialValue) noexcept
       : BigInt{static_cast<std::uintmax_t>(initialValue), initial_size<T>,
                false} {}
-  // string_view构造
+  // string_view构造，十进制
   explicit BigInt(std::string_view initialValue);
 
+  // 复制视图引用的数据
+  explicit BigInt(const BigIntView &N);
+  // 按base进制解析整个字符串，可以有开头的'-'，不接受"0x"等前缀
+  // base为10或2的幂（2到32），字母大小写均可，格式错误时抛出std::invalid_argument
+  explicit BigInt(std::string_view text, int base);
+
   // 不复制多余脏数据空间
   BigInt(const BigInt &N) noexcept;
   // 移动构造
   BigInt(BigInt &&N) noexcept;
   // assign赋值复制运算
   auto operator=(const BigInt &N) & noexcept -> BigInt &;
-  // 移动复制运算符
+  // 移动复制运算符，两者内存资源不同时退化为复制
   auto operator=(BigInt &&N) & noexcept -> BigInt &;
+
+  // 内存资源，默认使用new/delete，可以按线程替换为任意std::pmr::memory_resource
+  // 当前线程新构造的对象和算法内部的临时缓冲区都从默认资源分配
+  [[nodiscard]] static auto default_resource() noexcept
+      -> std::pmr::memory_resource *;
+  // 返回原来的默认资源，传入nullptr恢复为new/delete
+  static auto set_default_resource(std::pmr::memory_resource *resource) noexcept
+      -> std::pmr::memory_resource *;
+  [[nodiscard]] auto get_resource() const noexcept
+      -> std::pmr::memory_resource * {
+    return resource_;
+  }
+  class resource_scope;
+  class arena;
+  // limb加减和比较使用的指令集，默认按CPUID选择CPU支持的最高级别
+  enum class simd_level { scalar, avx2, avx512 };
+  [[nodiscard]] static auto get_simd_level() noexcept -> simd_level;
+  // 当前CPU支持的最高级别
+  [[nodiscard]] static auto max_simd_level() noexcept -> simd_level;
+  // 全局生效，超过CPU支持的级别时降到支持的最高级别，返回实际生效的级别
+  // 主要用于测试和性能对比，实现见my_bigint_simd.cpp
+  static auto set_simd_level(simd_level level) noexcept -> simd_level;
+  // 并行计算，默认关闭，实现见my_bigint_parallel.cpp
+  // threads为参与计算的线程数，包括调用线程，0或1表示关闭
+  // 乘法和除法中较短一方达到cutoff_limbs个limb后，子乘法和NTT变换才拆给线程池
+  // 会销毁原来的线程池，不能在其他线程正在计算时调用
+  static constexpr size_type default_parallel_cutoff = 1000;
+  static auto set_parallel(size_type threads,
+                           size_type cutoff_limbs = default_parallel_cutoff)
+      -> void;
+  [[nodiscard]] static auto parallel_threads() noexcept -> size_type;
+  // 运行统计，实现见my_bigint_instrument.cpp
+  // 只有定义了MY_BIGINT_INSTRUMENT（CMake选项MY_BIGINT_INSTRUMENT=ON）时才记录，
+  // 否则记录代码全部编译掉，查询结果全为0
+#ifdef MY_BIGINT_INSTRUMENT
+  static constexpr bool instrumented = true;
+#else
+  static constexpr bool instrumented = false;
+#endif
+  // 构造包括复制构造，加法包括减法，除法包括取余；不在任何运算内的分配记为other
+  enum class operation { construct, add, multiply, divide, other };
+  static constexpr size_type operation_count = 5;
+  struct statistics;
+  // 当前线程的统计
+  [[nodiscard]] static auto thread_statistics() -> statistics;
+  // 所有线程的统计之和，包括已经退出的线程
+  [[nodiscard]] static auto global_statistics() -> statistics;
+  // 清零所有线程的统计，其他线程正在计算时可能漏掉少量计数
+  static auto reset_statistics() noexcept -> void;
   // 计算算法
 private:
   // 默认构造不初始化，内部实现其他函数的时候调用
   auto fillZero() -> void;
-  // 计算后必须调用此函数，逻辑上去除计算后最高位的0，同时调试版本检查计算结果，避免-0的存在
+  // 计算后必须调用此函数，逻辑上去除计算后最高位的0，同时避免-0的存在
   auto getLength(const size_type maxlength) -> size_type;
   // 没必要的私有函数
   // [[nodiscard]] auto getLength() const -> size_type { return length_; }
@@ -72,28 +174,152 @@ private:
   auto un_negative_zero() -> bool;
   // 内部判断是否为0
   [[nodiscard]] auto Is_zero() const -> bool;
+  // 10的n次幂，二分求幂
+  static auto ten_pow(size_type n) -> BigInt;
+  // 十进制转换，超过阈值后按缓存的10^(9*2^k)分治，实现见my_bigint_radix.cpp
+  // digits只含数字，返回非负数
+  static auto from_decimal(std::string_view digits) -> BigInt;
+  // 写入|x|的十进制，width>0时高位补0到恰好width位，否则不补0，返回结尾
+  // width>0时调用方保证空间足够；width为0时写到last之前，放不下时返回nullptr
+  // 不超过300个limb时在栈上计算，不分配内存
+  static auto write_decimal(char *out, const BigInt &x, size_type width,
+                            const char *last) -> char *;
+  // 按limb移位，k>0乘B^k，k<0除B^-k（绝对值截断，符号不变）
+  [[nodiscard]] auto limb_shift(std::intmax_t k) const -> BigInt;
+  // 按二进制位移位，bits>0乘2^bits，bits<0除2^-bits（绝对值截断，符号不变）
+  [[nodiscard]] auto abs_shift(std::intmax_t bits) const -> BigInt;
+  // 绝对值的低k个limb，即|x| mod B^k
+  [[nodiscard]] auto low_limbs(size_type k) const -> BigInt;
+  // <<、>>的实现，bits为移位数的绝对值，实现见my_bigint_bits.cpp
+  [[nodiscard]] auto shift_left(std::uintmax_t bits) const -> BigInt;
+  [[nodiscard]] auto shift_right(std::uintmax_t bits) const -> BigInt;
+  auto shift_left_in_place(std::uintmax_t bits) -> BigInt &;
+  auto shift_right_in_place(std::uintmax_t bits) -> BigInt &;
 
 public:
+  // 十进制移位，n>0乘10^n，n<0除10^-n（向0取整）
   [[nodiscard]] auto pow_of_ten(const std::intmax_t n) const -> BigInt;
+  // 十进制字符串
+  [[nodiscard]] auto to_string() const -> std::string;
+  // 与std::to_chars、std::from_chars相同的约定，十进制，实现见my_bigint_radix.cpp
+  // 写入[first,last)，空间不足时返回{last, errc::value_too_large}，不写结尾的'\0'
+  // 直接写入调用方的缓冲区，不超过300个limb（约2890位十进制数）时不分配内存；
+  // 更长的数分治转换中的除法需要临时空间，从当前线程的默认资源分配
+  friend auto to_chars(char *first, char *last, const BigInt &N)
+      -> std::to_chars_result;
+  // 解析开头的"-?[0-9]+"，结果写入N，复用N已有的空间；没有数字时N不变，
+  // 返回{first, errc::invalid_argument}
+  friend auto from_chars(const char *first, const char *last, BigInt &N)
+      -> std::from_chars_result;
+  // 2的幂进制按位直接转换，O(n)，实现见my_bigint_bits.cpp
+  // base为10或2、4、8、16、32，其他进制抛出std::invalid_argument；负数为'-'加绝对值，字母小写
+  [[nodiscard]] auto to_string(int base) const -> std::string;
+  friend auto to_chars(char *first, char *last, const BigInt &N, int base)
+      -> std::to_chars_result;
+  // 字母大小写均可
+  friend auto from_chars(const char *first, const char *last, BigInt &N,
+                         int base) -> std::from_chars_result;
+  // 二进制移位，O(n)；右移按补码语义向负无穷取整，与有符号整数的>>相同
+  // 移位数为负时反向移位，x << -n == x >> n；
+  // 左移后的二进制位数超出size_type时抛出std::length_error
+  template <std::integral T>
+  [[nodiscard]] auto operator<<(T bits) const -> BigInt {
+    return is_negative(bits) ? shift_right(magnitude(bits))
+                             : shift_left(magnitude(bits));
+  }
+  template <std::integral T>
+  [[nodiscard]] auto operator>>(T bits) const -> BigInt {
+    return is_negative(bits) ? shift_left(magnitude(bits))
+                             : shift_right(magnitude(bits));
+  }
+  template <std::integral T> auto operator<<=(T bits) -> BigInt & {
+    return is_negative(bits) ? shift_right_in_place(magnitude(bits))
+                             : shift_left_in_place(magnitude(bits));
+  }
+  template <std::integral T> auto operator>>=(T bits) -> BigInt & {
+    return is_negative(bits) ? shift_left_in_place(magnitude(bits))
+                             : shift_right_in_place(magnitude(bits));
+  }
+  // 按位运算，负数视为无限长的补码，与有符号整数相同，~x == -x-1
+  [[nodiscard]] auto operator&(const BigInt &N) const -> BigInt;
+  [[nodiscard]] auto operator|(const BigInt &N) const -> BigInt;
+  [[nodiscard]] auto operator^(const BigInt &N) const -> BigInt;
+  [[nodiscard]] auto operator~() const -> BigInt;
+  auto operator&=(const BigInt &N) -> BigInt &;
+  auto operator|=(const BigInt &N) -> BigInt &;
+  auto operator^=(const BigInt &N) -> BigInt &;
+  template <std::integral T> auto operator&(T N) const -> BigInt {
+    return *this & BigInt{N};
+  }
+  template <std::integral T> auto operator|(T N) const -> BigInt {
+    return *this | BigInt{N};
+  }
+  template <std::integral T> auto operator^(T N) const -> BigInt {
+    return *this ^ BigInt{N};
+  }
+  template <std::integral T> auto operator&=(T N) -> BigInt & {
+    return *this &= BigInt{N};
+  }
+  template <std::integral T> auto operator|=(T N) -> BigInt & {
+    return *this |= BigInt{N};
+  }
+  template <std::integral T> auto operator^=(T N) -> BigInt & {
+    return *this ^= BigInt{N};
+  }
+  template <std::integral T>
+  friend auto operator&(T N, const BigInt &B) -> BigInt {
+    return B & N;
+  }
+  template <std::integral T>
+  friend auto operator|(T N, const BigInt &B) -> BigInt {
+    return B | N;
+  }
+  template <std::integral T>
+  friend auto operator^(T N, const BigInt &B) -> BigInt {
+    return B ^ N;
+  }
 
-private:
-  // x= x*10+n,x需要提前手动分配好足够空间
-  auto back_inserter(const value_type n) -> BigInt;
+  // 二进制序列化，实现见my_bigint_serialize.cpp
+  // 16字节的头之后是小端序的limb，头部依次为魔数"BIGI"、2字节版本号、
+  // 2字节标志（最低位为符号）、8字节limb个数，都按小端序存放
+  // 记录之间不需要分隔，一个文件可以连续存放多个数，limb总是4字节对齐
+  static constexpr std::uint16_t serialization_version = 1;
+  static constexpr size_type serialization_header_size = 16;
+  [[nodiscard]] auto serialized_size() const noexcept -> size_type;
+  // out至少有serialized_size()字节，返回写入的字节数
+  auto serialize(std::span<std::byte> out) const -> size_type;
+  // 写入失败时只设置流的状态，与operator<<相同
+  auto save(std::ostream &out) const -> void;
+  // 读取开头的一个数，魔数、版本不符或数据不完整时抛出std::invalid_argument
+  [[nodiscard]] static auto deserialize(std::span<const std::byte> bytes)
+      -> BigInt;
+  // 读取一个数，流停在这个数之后
+  [[nodiscard]] static auto load(std::istream &in) -> BigInt;
+  class mapped_file;
+
+  // 原地除以整数，商向0取整写回自身，一次遍历，不分配内存，除数为0时抛出异常
+  // 返回余数，与被除数同号；无符号除数时返回余数的绝对值
+  template <std::integral T> auto divmod_small(T N) -> T {
+    const bool negative = negative_;
+    const std::uintmax_t remainder =
+        divmod_small_uint(magnitude(N), is_negative(N));
+    if constexpr (std::is_signed_v<T>)
+      return static_cast<T>(negative ? std::uintmax_t{0} - remainder
+                                     : remainder);
+    else
+      return static_cast<T>(remainder);
+  }
 
   // 公共简单函数类，开销小的尽量内联，类内定义
 public:
-  // 逆序输出，
-  friend auto operator<<(std::ostream &out, const BigInt &N) -> std::ostream & {
-    out << (N.negative_ ? "-" : "");
-    for (size_type i = N.length_; i-- > 0;)
-      out << static_cast<int>(N[i]);
-    return out;
-  }
+  // 十进制输出，先用to_chars写入缓冲区再整段插入，宽度和填充仍然有效
+  friend auto operator<<(std::ostream &out, const BigInt &N) -> std::ostream &;
   // O(n)单目运算符取反，完整复制构造开销
   auto operator-() const -> BigInt;
   // 右值取反，用于处理临时对象,避免构造开销
   friend auto operator-(BigInt &&N) -> BigInt & {
     N.negative_ = !N.negative_;
+    N.un_negative_zero();
     return N;
   }
   // 复制构造开销
@@ -126,8 +352,102 @@ private:
   // 同号加法,无视N符号继承this符号
   auto samNAdd(const BigInt &N) const -> BigInt;
 
-  // 用于/%重载
+  // 以下为复合赋值用的原地运算，实现见my_bigint.cpp
+  // 容量不足n时至少按两倍扩容，保留原有的length_个limb
+  auto reserve(size_type n) -> void;
+  // 原地加上符号为b_negative的b[0,bn)，b可以是自身的array_
+  auto add_in_place(const value_type *b, size_type bn, bool b_negative)
+      -> void;
+  // 原地乘以符号为b_negative的b[0,bn)，b可以是自身的array_
+  auto mul_in_place(const value_type *b, size_type bn, bool b_negative)
+      -> void;
+  // 与整数的加法和乘法，结果一次写出，N_is_negative表示整数的符号
+  auto add_integral(std::uintmax_t N, bool N_is_negative) const -> BigInt;
+  auto mul_integral(std::uintmax_t N, bool N_is_negative) const -> BigInt;
+  // 与整数比较，返回-1、0、1
+  auto cmp_integral(std::uintmax_t N, bool N_is_negative) const noexcept
+      -> int;
+  // 整数拆成limb后调用上面两个函数
+  auto add_in_place(std::uintmax_t N, bool N_is_negative) -> void;
+  auto mul_in_place(std::uintmax_t N, bool N_is_negative) -> void;
+  // 原地除法，向0取整，keep_remainder为true时保留余数而不是商
+  // 实现见my_bigint_div.cpp
+  auto divide_in_place(std::uintmax_t N, bool N_is_negative,
+                       bool keep_remainder) -> void;
+  auto divide_in_place(const BigInt &N, bool keep_remainder) -> void;
+  // 整数的绝对值，最小值先转为无符号避免溢出
+  template <std::integral T>
+  static constexpr auto magnitude(T N) noexcept -> std::uintmax_t {
+    if constexpr (std::is_signed_v<T>)
+      return N < T{0} ? std::uintmax_t{0} - static_cast<std::uintmax_t>(N)
+                      : static_cast<std::uintmax_t>(N);
+    else
+      return static_cast<std::uintmax_t>(N);
+  }
+  template <std::integral T>
+  static constexpr auto is_negative(T N) noexcept -> bool {
+    if constexpr (std::is_signed_v<T>)
+      return N < T{0};
+    else
+      return false;
+  }
+
+  // 乘法分级，实现见my_bigint_mul.cpp
+  // r[0,an+bn) = a*b，要求an>=bn>=1，r不能与a、b重合
+  // 按较短乘数长度依次选择 basecase -> Karatsuba -> Toom-3 -> NTT，
+  // 两乘数长度相差一倍以上时先按较短乘数分块
+  static auto mul_limbs(value_type *r, const value_type *a, size_type an,
+                        const value_type *b, size_type bn) -> void;
+  // 一分为二，三次子乘法
+  static auto mul_karatsuba(value_type *r, const value_type *a, size_type an,
+                            const value_type *b, size_type bn) -> void;
+  // 一分为三，在0,1,-1,2,∞取值，五次子乘法
+  static auto mul_toom3(value_type *r, const value_type *a, size_type an,
+                        const value_type *b, size_type bn) -> void;
+  // 平方分级，r[0,2n) = a^2，r不能与a重合，mul_limbs遇到a==b时自动转到这里
+  static auto sqr_limbs(value_type *r, const value_type *a, size_type n)
+      -> void;
+  // 一分为二，三次子平方
+  static auto sqr_karatsuba(value_type *r, const value_type *a, size_type n)
+      -> void;
+  // 较长乘数按较短乘数长度切块，逐块相乘后累加
+  static auto mul_unbalanced(value_type *r, const value_type *a, size_type an,
+                             const value_type *b, size_type bn) -> void;
+  // 由limb数组构造非负数
+  static auto from_limbs(const value_type *a, size_type n) -> BigInt;
+  // 按位运算的公共部分，op对两个补码limb逐个计算，negative为结果的符号
+  template <class Op>
+  auto bitwise(const BigInt &N, bool negative, Op op) const -> BigInt;
+
+  // 用于/%重载，除数和商都足够长时选择递归除法，实现见my_bigint_div.cpp
   auto divide(const BigInt &N) const -> bigInt_division_result;
+  // Knuth算法D，O(n*m)
+  auto divide_basecase(const BigInt &N) const -> bigInt_division_result;
+  // Burnikel-Ziegler递归除法，把除法转化为快速乘法，绝对值运算
+  auto divide_large(const BigInt &N) const -> bigInt_division_result;
+  // 要求A>=0，B最高位为1且A < B^m * B，返回A除以B的商和余数
+  static auto divide_recursive(const BigInt &A, const BigInt &B, size_type m)
+      -> bigInt_division_result;
+  // 牛顿迭代求倒数，返回floor(B^(2n)/D)，n为D的limb数
+  static auto reciprocal(const BigInt &D) -> BigInt;
+  // Barrett除法，要求0<=x<B^(2n)，mu = reciprocal(D)，商和余数都非负
+  static auto divide_barrett(const BigInt &x, const BigInt &D,
+                             const BigInt &mu) -> bigInt_division_result;
+  // 绝对值的低64位
+  [[nodiscard]] auto low_word() const noexcept -> std::uintmax_t {
+    std::uintmax_t value = array_[0];
+    if (length_ > 1)
+      value |= static_cast<std::uintmax_t>(array_[1]) << limb_bits;
+    return value;
+  }
+  // q[0,n) = a[0,n) / N，不超过一个limb的除数用64位中间结果，否则用128位
+  // 返回余数，q可以与a重合
+  static auto divmod_small_limbs(value_type *q, const value_type *a,
+                                 size_type n, std::uintmax_t N)
+      -> std::uintmax_t;
+  // 原地除以整数，商向0取整，返回余数的绝对值
+  auto divmod_small_uint(std::uintmax_t N, bool N_is_negative)
+      -> std::uintmax_t;
   // 利用基本整数类加速运算
   auto
   divide_integer_uint(std::uintmax_t N, bool N_is_negative,
@@ -144,22 +464,80 @@ private:
 public:
   auto operator+(const BigInt &N) const -> BigInt;
   auto operator-(const BigInt &N) const -> BigInt;
+  // 同一个对象相乘时自动改用平方
   auto operator*(const BigInt &N) const -> BigInt;
-  // 大整数之间除法，效率很低
+  // 平方，交叉项只算一次，约为一般乘法一半的部分积
+  [[nodiscard]] auto square() const -> BigInt;
+  // 大整数之间除法，Knuth算法D，大除数时Burnikel-Ziegler递归除法
   auto operator/(const BigInt &N) const -> BigInt;
   auto operator%(const BigInt &N) const -> BigInt;
-  // 不支持负数幂运算
+  // 不支持负数幂运算，二进制快速幂
   friend auto pow(const BigInt &N, const size_type &exponent) -> BigInt;
+  // 批量求和与求积，实现见my_bigint_batch.cpp
+  // sum在一个缓冲区中逐limb累加，进位推迟到最后，不产生中间结果
+  // product用按长度平衡的乘积树，空序列的积为1
+  // 用set_parallel开启线程池后，足够长的输入分成两半并行计算
+  [[nodiscard]] static auto sum(std::span<const BigInt> values) -> BigInt;
+  [[nodiscard]] static auto product(std::span<const BigInt> values) -> BigInt;
+  // 模幂base^exponent mod modulus，结果在[0,modulus)
+  // 要求modulus>0、exponent>=0，否则抛出异常，实现见my_bigint_mod.cpp
+  // 同一个模数反复计算时构造modular_context，复用预计算的约简常数
+  [[nodiscard]] static auto powmod(const BigInt &base, const BigInt &exponent,
+                                   const BigInt &modulus) -> BigInt;
+  class modular_context;
+  // 最大公约数，结果非负，gcd(0, 0) == 0，实现见my_bigint_gcd.cpp
+  // 64位以内用二进制GCD，较短时用Lehmer算法，较长时用half-GCD递归，O(M(n)log n)
+  [[nodiscard]] static auto gcd(const BigInt &a, const BigInt &b) -> BigInt;
+  struct xgcd_result;
+  // 扩展欧几里得，a*x + b*y == gcd；b不为0时x在[0, |b|/gcd)中，结果唯一
+  [[nodiscard]] static auto xgcd(const BigInt &a, const BigInt &b)
+      -> xgcd_result;
+  // a模m的逆元，结果在[0, m)；m不为正或a与m不互素时抛出std::invalid_argument
+  [[nodiscard]] static auto modinv(const BigInt &a, const BigInt &m) -> BigInt;
+  // 平方根和k次方根，向零取整，实现见my_bigint_root.cpp
+  // 牛顿迭代，由高位部分递归求近似值，每层精度翻倍，总开销为常数次全长乘除法
+  // 负数开平方（偶数次方）或k为0时抛出std::invalid_argument
+  [[nodiscard]] static auto isqrt(const BigInt &N) -> BigInt;
+  [[nodiscard]] static auto iroot(const BigInt &N, size_type k) -> BigInt;
+  // 是否存在整数b和k>=2使b^k == N，0、1和-1都是
+  [[nodiscard]] static auto is_perfect_power(const BigInt &N) -> bool;
 
+private:
+  // GCD的内部实现，定义见my_bigint_gcd.cpp
+  class gcd_engine;
+  // 开方的内部实现，定义见my_bigint_root.cpp
+  class root_engine;
+  // values非空且没有0，total为values的limb数之和
+  static auto product_tree(std::span<const BigInt> values, size_type total)
+      -> BigInt;
+
+public:
   // 算符重载没有
 
-  template <class T> auto operator+(const T &N) const -> BigInt {
+  // 与整数运算不构造临时BigInt，一次遍历写出结果
+  template <std::integral T> auto operator+(T N) const -> BigInt {
+    return add_integral(magnitude(N), is_negative(N));
+  }
+  template <std::integral T> auto operator-(T N) const -> BigInt {
+    return add_integral(magnitude(N), !is_negative(N));
+  }
+  template <std::integral T> auto operator*(T N) const -> BigInt {
+    return mul_integral(magnitude(N), is_negative(N));
+  }
+  // 字符串等其他类型先构造
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator+(const T &N) const -> BigInt {
     return *this + BigInt{N};
   }
-  template <class T> auto operator-(const T &N) const -> BigInt {
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator-(const T &N) const -> BigInt {
     return *this - BigInt{N};
   }
-  template <class T> auto operator*(const T &N) const -> BigInt {
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator*(const T &N) const -> BigInt {
     return *this * BigInt{N};
   }
   // 除整数重载 利用基本整数类加速运算
@@ -177,15 +555,34 @@ public:
     return *this % BigInt{N};
   }
 
+  template <std::integral T>
+  friend auto operator+(T N, const BigInt &B) -> BigInt {
+    return B + N;
+  }
+  // N-B = -(B-N)
+  template <std::integral T>
+  friend auto operator-(T N, const BigInt &B) -> BigInt {
+    BigInt result{B - N};
+    result.negative_ = !result.negative_;
+    result.un_negative_zero();
+    return result;
+  }
+  template <std::integral T>
+  friend auto operator*(T N, const BigInt &B) -> BigInt {
+    return B * N;
+  }
   template <class T>
+    requires(!std::integral<T>)
   friend auto operator+(const T &N, const BigInt &B) -> BigInt {
     return BigInt{N} + B;
   }
   template <class T>
+    requires(!std::integral<T>)
   friend auto operator-(const T &N, const BigInt &B) -> BigInt {
     return BigInt{N} - B;
   }
   template <class T>
+    requires(!std::integral<T>)
   friend auto operator*(const T &N, const BigInt &B) -> BigInt {
     return BigInt{N} * B;
   }
@@ -197,23 +594,139 @@ public:
   friend auto operator%(const T &N, const BigInt &B) -> BigInt {
     return BigInt{N} % B;
   }
+  // 右值重载，结果写入即将销毁的操作数，省去结果的分配
+  friend auto operator+(BigInt &&A, const BigInt &B) -> BigInt {
+    return std::move(A += B);
+  }
+  friend auto operator+(const BigInt &A, BigInt &&B) -> BigInt {
+    return std::move(B += A);
+  }
+  friend auto operator+(BigInt &&A, BigInt &&B) -> BigInt {
+    return std::move(A += B);
+  }
+  friend auto operator-(BigInt &&A, const BigInt &B) -> BigInt {
+    return std::move(A -= B);
+  }
+  // A-B = -(B-A)
+  friend auto operator-(const BigInt &A, BigInt &&B) -> BigInt {
+    B -= A;
+    B.negative_ = !B.negative_;
+    B.un_negative_zero();
+    return std::move(B);
+  }
+  friend auto operator-(BigInt &&A, BigInt &&B) -> BigInt {
+    return std::move(A -= B);
+  }
+  friend auto operator*(BigInt &&A, const BigInt &B) -> BigInt {
+    return std::move(A *= B);
+  }
+  friend auto operator*(const BigInt &A, BigInt &&B) -> BigInt {
+    return std::move(B *= A);
+  }
+  friend auto operator*(BigInt &&A, BigInt &&B) -> BigInt {
+    return std::move(A *= B);
+  }
+  // 商和余数写入被除数
+  friend auto operator/(BigInt &&A, const BigInt &B) -> BigInt {
+    return std::move(A /= B);
+  }
+  friend auto operator%(BigInt &&A, const BigInt &B) -> BigInt {
+    return std::move(A %= B);
+  }
+  template <std::integral T>
+  friend auto operator+(BigInt &&A, T N) -> BigInt {
+    return std::move(A += N);
+  }
+  template <std::integral T>
+  friend auto operator+(T N, BigInt &&B) -> BigInt {
+    return std::move(B += N);
+  }
+  template <std::integral T>
+  friend auto operator-(BigInt &&A, T N) -> BigInt {
+    return std::move(A -= N);
+  }
+  template <std::integral T>
+  friend auto operator-(T N, BigInt &&B) -> BigInt {
+    B -= N;
+    B.negative_ = !B.negative_;
+    B.un_negative_zero();
+    return std::move(B);
+  }
+  template <std::integral T>
+  friend auto operator*(BigInt &&A, T N) -> BigInt {
+    return std::move(A *= N);
+  }
+  template <std::integral T>
+  friend auto operator*(T N, BigInt &&B) -> BigInt {
+    return std::move(B *= N);
+  }
+  template <std::integral T>
+  friend auto operator/(BigInt &&A, T N) -> BigInt {
+    return std::move(A /= N);
+  }
+  template <std::integral T>
+  friend auto operator%(BigInt &&A, T N) -> BigInt {
+    return std::move(A %= N);
+  }
   template <class T> auto operator=(const T &N) -> BigInt & {
     return *this = BigInt{N};
   }
-  template <class T> auto operator+=(const T &N) -> BigInt & {
-    return *this = *this + N;
+  // 复合赋值原地计算，容量足够时不分配内存
+  auto operator+=(const BigInt &N) -> BigInt &;
+  auto operator-=(const BigInt &N) -> BigInt &;
+  auto operator*=(const BigInt &N) -> BigInt &;
+  auto operator/=(const BigInt &N) -> BigInt &;
+  auto operator%=(const BigInt &N) -> BigInt &;
+  // 视图直接参与加减乘，不复制到临时BigInt
+  auto operator+=(const BigIntView &N) -> BigInt &;
+  auto operator-=(const BigIntView &N) -> BigInt &;
+  auto operator*=(const BigIntView &N) -> BigInt &;
+  // 整数不构造临时BigInt
+  template <std::integral T> auto operator+=(T N) -> BigInt & {
+    add_in_place(magnitude(N), is_negative(N));
+    return *this;
+  }
+  template <std::integral T> auto operator-=(T N) -> BigInt & {
+    add_in_place(magnitude(N), !is_negative(N));
+    return *this;
   }
-  template <class T> auto operator-=(const T &N) -> BigInt & {
-    return *this = *this - N;
+  template <std::integral T> auto operator*=(T N) -> BigInt & {
+    mul_in_place(magnitude(N), is_negative(N));
+    return *this;
   }
-  template <class T> auto operator*=(const T &N) -> BigInt & {
-    return *this = *this * N;
+  template <std::integral T> auto operator/=(T N) -> BigInt & {
+    divide_in_place(magnitude(N), is_negative(N), false);
+    return *this;
+  }
+  template <std::integral T> auto operator%=(T N) -> BigInt & {
+    divide_in_place(magnitude(N), is_negative(N), true);
+    return *this;
+  }
+  // 字符串等其他类型先构造
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator+=(const T &N) -> BigInt & {
+    return *this += BigInt{N};
   }
-  template <class T> auto operator/=(const T &N) -> BigInt & {
-    return *this = *this / N;
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator-=(const T &N) -> BigInt & {
+    return *this -= BigInt{N};
+  }
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator*=(const T &N) -> BigInt & {
+    return *this *= BigInt{N};
+  }
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator/=(const T &N) -> BigInt & {
+    return *this /= BigInt{N};
   }
-  template <class T> auto operator%=(const T &N) -> BigInt & {
-    return *this = *this % N;
+  template <class T>
+    requires(!std::integral<T>)
+  auto operator%=(const T &N) -> BigInt & {
+    return *this %= BigInt{N};
   }
 
 public:
@@ -222,7 +735,7 @@ public:
       return false;
     return cmp_abs_equal(*this, N);
   }
-  // 从最高位开始依次比较，输出第一个不同数字位的比较结果
+  // 从最高位开始依次比较，输出第一个不同limb的比较结果
   auto operator<(const BigInt &N) const -> bool {
     if (!negative_ && N.negative_) // 正数大于负数
       return false;
@@ -230,9 +743,17 @@ public:
       return true;
     // 同为负数转换为正数比较//return !(-*this < -N);
     if (negative_ && N.negative_)
-      return !cmp_abs_less(N);
+      return N.cmp_abs_less(*this);
     return cmp_abs_less(N);
   }
+  // 与整数比较，不构造临时BigInt，反向和其余比较由编译器改写
+  template <std::integral T> auto operator==(T N) const noexcept -> bool {
+    return cmp_integral(magnitude(N), is_negative(N)) == 0;
+  }
+  template <std::integral T>
+  auto operator<=>(T N) const noexcept -> std::strong_ordering {
+    return cmp_integral(magnitude(N), is_negative(N)) <=> 0;
+  }
   auto operator!=(const BigInt &N) const -> bool { return !(*this == N); }
   auto operator>(const BigInt &N) const -> bool { return N < *this; }
   auto operator>=(const BigInt &N) const -> bool { return !(*this < N); }
@@ -249,29 +770,498 @@ struct BigInt::bigInt_division_result {
   BigInt remainder{0}; // 余数
 };
 
+struct BigInt::xgcd_result {
+  BigInt gcd{0};
+  BigInt x{0}, y{0};
+};
+
+// 每种运算的统计，只记录用户直接调用的最外层运算，内部嵌套的运算计入外层
+// 耗时包含嵌套运算，线程池中的子任务的分配和复制计入发起任务的运算
+struct BigInt::statistics {
+  // 较长操作数的limb数按2的幂分桶，第k桶统计[2^k, 2^(k+1))
+  static constexpr size_type histogram_buckets = 48;
+  struct counters {
+    std::uint64_t calls = 0;
+    std::uint64_t nanoseconds = 0;
+    // 堆分配次数和字节数，包括内部临时缓冲区
+    std::uint64_t allocations = 0;
+    std::uint64_t allocated_bytes = 0;
+    // 复制构造、复制赋值和资源不同时退化为复制的移动赋值
+    std::uint64_t copies = 0;
+    std::uint64_t limb_histogram[histogram_buckets] = {};
+  };
+  counters operations[operation_count];
+
+  [[nodiscard]] auto operator[](operation op) noexcept -> counters & {
+    return operations[static_cast<size_type>(op)];
+  }
+  [[nodiscard]] auto operator[](operation op) const noexcept
+      -> const counters & {
+    return operations[static_cast<size_type>(op)];
+  }
+  auto operator+=(const statistics &other) noexcept -> statistics &;
+  // 每种运算一行汇总，之后是非空的limb数分桶
+  friend auto operator<<(std::ostream &out, const statistics &stats)
+      -> std::ostream &;
+};
+
+// 作用域内替换当前线程的默认资源，离开时恢复
+class BigInt::resource_scope {
+  std::pmr::memory_resource *previous_;
+
+public:
+  explicit resource_scope(std::pmr::memory_resource *resource) noexcept
+      : previous_{set_default_resource(resource)} {}
+  ~resource_scope() { set_default_resource(previous_); }
+  resource_scope(const resource_scope &) = delete;
+  auto operator=(const resource_scope &) -> resource_scope & = delete;
+};
+
+// 线程内的内存池，按大小分级复用释放的内存，析构时一次性归还上游
+// 作用域内构造的对象不能比arena活得更久，需要保留的结果移动赋值给作用域外
+// 构造的对象，资源不同时会复制到该对象自己的资源上
+// 需要单调递增的bump分配时，可以传入std::pmr::monotonic_buffer_resource作为上游
+class BigInt::arena {
+  std::pmr::unsynchronized_pool_resource pool_;
+  resource_scope scope_;
+
+public:
+  arena() : pool_{}, scope_{&pool_} {}
+  explicit arena(std::pmr::memory_resource *upstream)
+      : pool_{upstream}, scope_{&pool_} {}
+  arena(const arena &) = delete;
+  auto operator=(const arena &) -> arena & = delete;
+  [[nodiscard]] auto resource() noexcept -> std::pmr::memory_resource * {
+    return &pool_;
+  }
+};
+
+// 固定模数的模运算，构造时预计算约简常数，之后的乘法和模幂都复用
+// 较短的奇数模数用Montgomery约简，逐limb消去低位，不需要试商
+// 其余模数用Barrett约简，预先求模数的倒数，每次约简只需两次乘法
+class BigInt::modular_context {
+  BigInt modulus_;
+  // Barrett：floor(B^(2n)/modulus)，n为模数的limb数
+  BigInt reciprocal_;
+  // Montgomery：R = B^n，r2_ = R^2 mod modulus，inverse_ = -modulus^-1 mod B
+  // 奇数的逆元也是奇数，inverse_为0表示使用Barrett约简
+  BigInt r2_;
+  value_type inverse_{0};
+
+  // 约简域中的乘法，x = x*y，y可以是x本身
+  // Montgomery域中结果为x*y/R mod modulus，scratch至少2n+1个limb
+  auto mul_reduce(BigInt &x, const BigInt &y, value_type *scratch) const
+      -> void;
+  // 进入和离开约简域，Barrett约简的约简域就是普通的余数
+  [[nodiscard]] auto to_domain(const BigInt &x, value_type *scratch) const
+      -> BigInt;
+  auto from_domain(BigInt &x, value_type *scratch) const -> void;
+
+public:
+  explicit modular_context(const BigInt &modulus);
+  [[nodiscard]] auto modulus() const noexcept -> const BigInt & {
+    return modulus_;
+  }
+  [[nodiscard]] auto is_montgomery() const noexcept -> bool {
+    return inverse_ != 0;
+  }
+  // x mod modulus，负数也返回[0,modulus)中的值
+  [[nodiscard]] auto reduce(const BigInt &x) const -> BigInt;
+  // a*b mod modulus
+  [[nodiscard]] auto mul(const BigInt &a, const BigInt &b) const -> BigInt;
+  // base^exponent mod modulus，滑动窗口，只预计算奇数次幂
+  [[nodiscard]] auto pow(const BigInt &base, const BigInt &exponent) const
+      -> BigInt;
+};
+
+// 只读的数值视图，直接引用序列化数据或BigInt的limb，不复制
+// 被引用的内存必须比视图活得更久；可以作为复合赋值的右操作数，与BigInt互相比较
+class BigIntView {
+public:
+  using value_type = BigInt::value_type;
+  using size_type = BigInt::size_type;
+
+private:
+  const value_type *limbs_;
+  size_type length_;
+  bool negative_;
+
+public:
+  // 与std::string_view相同，可以从BigInt隐式转换，N修改后视图失效
+  BigIntView(const BigInt &N) noexcept
+      : limbs_{N.array_}, length_{N.length_}, negative_{N.negative_} {}
+  // 解析bytes开头的一个数，limb直接引用bytes，要求limb按4字节对齐
+  // 格式错误时抛出std::invalid_argument，大端序机器上无法直接引用，抛出std::runtime_error
+  explicit BigIntView(std::span<const std::byte> bytes);
+  // 引用规范化的limb数组：最高limb非0，0只有一个limb且不带符号
+  constexpr BigIntView(std::span<const value_type> limbs, bool negative) noexcept
+      : limbs_{limbs.data()}, length_{limbs.size()}, negative_{negative} {}
+
+  [[nodiscard]] auto limbs() const noexcept -> std::span<const value_type> {
+    return {limbs_, length_};
+  }
+  [[nodiscard]] auto is_negative() const noexcept -> bool { return negative_; }
+  [[nodiscard]] auto is_zero() const noexcept -> bool {
+    return length_ == 1 && limbs_[0] == 0;
+  }
+  // 序列化后的字节数，也是下一个数在文件中的偏移增量
+  [[nodiscard]] auto serialized_size() const noexcept -> size_type {
+    return BigInt::serialization_header_size + length_ * sizeof(value_type);
+  }
+  // 十进制转换需要可写的副本
+  [[nodiscard]] auto to_string() const -> std::string {
+    return BigInt{*this}.to_string();
+  }
+  friend auto operator<<(std::ostream &out, const BigIntView &N)
+      -> std::ostream & {
+    return out << N.to_string();
+  }
+  friend auto operator<=>(const BigIntView &A, const BigIntView &B) noexcept
+      -> std::strong_ordering;
+  friend auto operator==(const BigIntView &A, const BigIntView &B) noexcept
+      -> bool {
+    return (A <=> B) == 0;
+  }
+};
+
+// 编译期常量用的定长整数，最多Limbs个limb，不分配内存，所有运算都是constexpr
+// BigInt的存储来自运行时的内存资源，运算分派到SIMD内核，无法在常量表达式中使用；
+// 预先算好的幂、模数等常量用FixedBigInt在编译期求出，运行时转换为BigIntView直接参与运算，
+// 或由BigInt{c}复制limb得到BigInt，不再在启动时解析字符串
+// 加、减、乘的结果类型足够放下结果；复合赋值和缩小容量的转换放不下时抛出std::overflow_error，
+// 在常量表达式中即为编译错误
+template <std::size_t Limbs> class FixedBigInt;
+template <std::size_t L, std::size_t M>
+constexpr auto operator+(const FixedBigInt<L> &A, const FixedBigInt<M> &B)
+    -> FixedBigInt<(L > M ? L : M) + 1>;
+template <std::size_t L, std::size_t M>
+constexpr auto operator-(const FixedBigInt<L> &A, const FixedBigInt<M> &B)
+    -> FixedBigInt<(L > M ? L : M) + 1>;
+template <std::size_t L, std::size_t M>
+constexpr auto operator*(const FixedBigInt<L> &A, const FixedBigInt<M> &B)
+    -> FixedBigInt<L + M>;
+template <std::size_t L, std::size_t M>
+constexpr auto operator<=>(const FixedBigInt<L> &A,
+                           const FixedBigInt<M> &B) noexcept
+    -> std::strong_ordering;
+
+template <std::size_t Limbs> class FixedBigInt {
+  static_assert(Limbs > 0, "FixedBigInt needs at least one limb");
+
+public:
+  using value_type = BigInt::value_type;
+  using size_type = BigInt::size_type;
+  using wide_type = BigInt::wide_type;
+  static constexpr size_type capacity = Limbs;
+
+private:
+  template <std::size_t> friend class FixedBigInt;
+  template <std::size_t L, std::size_t M>
+  friend constexpr auto operator+(const FixedBigInt<L> &A,
+                                  const FixedBigInt<M> &B)
+      -> FixedBigInt<(L > M ? L : M) + 1>;
+  template <std::size_t L, std::size_t M>
+  friend constexpr auto operator-(const FixedBigInt<L> &A,
+                                  const FixedBigInt<M> &B)
+      -> FixedBigInt<(L > M ? L : M) + 1>;
+  template <std::size_t L, std::size_t M>
+  friend constexpr auto operator*(const FixedBigInt<L> &A,
+                                  const FixedBigInt<M> &B)
+      -> FixedBigInt<L + M>;
+  template <std::size_t L, std::size_t M>
+  friend constexpr auto operator<=>(const FixedBigInt<L> &A,
+                                    const FixedBigInt<M> &B) noexcept
+      -> std::strong_ordering;
+
+  // 与BigInt相同的规范化表示：length_为有效limb个数，0为一个limb且不带符号
+  // 常量表达式要求所有成员都已初始化，未用的limb保持为0
+  value_type limbs_[Limbs]{};
+  size_type length_ = 1;
+  bool negative_ = false;
+
+  constexpr auto normalize() noexcept -> void {
+    while (length_ > 1 && !limbs_[length_ - 1])
+      length_--;
+    if (length_ == 1 && !limbs_[0])
+      negative_ = false;
+  }
+  // 写入第i个limb，超出容量的limb必须为0
+  constexpr auto store(size_type i, value_type limb) -> void {
+    if (i < Limbs)
+      limbs_[i] = limb;
+    else if (limb)
+      throw std::overflow_error{"FixedBigInt overflow"};
+  }
+  // 原地乘以m再加上a，用于十进制解析
+  constexpr auto mul_add(value_type m, value_type a) -> void {
+    wide_type carry = a;
+    for (size_type i = 0; i < length_; i++) {
+      carry += static_cast<wide_type>(limbs_[i]) * m;
+      limbs_[i] = static_cast<value_type>(carry);
+      carry >>= BigInt::limb_bits;
+    }
+    // 先写入再增加长度，溢出时length_不会超过Limbs
+    if (carry) {
+      store(length_, static_cast<value_type>(carry));
+      length_++;
+    }
+    normalize();
+  }
+  // 比较a[0,an)和b[0,bn)的绝对值，返回-1、0、1
+  static constexpr auto cmp_abs(const value_type *a, size_type an,
+                                const value_type *b, size_type bn) noexcept
+      -> int {
+    if (an != bn)
+      return an < bn ? -1 : 1;
+    for (size_type i = an; i-- > 0;)
+      if (a[i] != b[i])
+        return a[i] < b[i] ? -1 : 1;
+    return 0;
+  }
+  // A + (b_negative ? -|B| : |B|)，加减法共用
+  template <std::size_t L, std::size_t M>
+  static constexpr auto signed_sum(const FixedBigInt<L> &A,
+                                   const FixedBigInt<M> &B, bool b_negative)
+      -> FixedBigInt {
+    FixedBigInt result;
+    const value_type *a = A.limbs_, *b = B.limbs_;
+    size_type an = A.length_, bn = B.length_;
+    bool negative = A.negative_;
+    if (A.negative_ == b_negative) {
+      if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+      }
+      wide_type carry = 0;
+      for (size_type i = 0; i < an; i++) {
+        carry += static_cast<wide_type>(a[i]) + (i < bn ? b[i] : 0);
+        result.store(i, static_cast<value_type>(carry));
+        carry >>= BigInt::limb_bits;
+      }
+      result.store(an, static_cast<value_type>(carry));
+    } else {
+      // 异号时大减小，结果取绝对值较大一方的符号
+      const int order = cmp_abs(a, an, b, bn);
+      if (!order)
+        return result;
+      if (order < 0) {
+        std::swap(a, b);
+        std::swap(an, bn);
+        negative = b_negative;
+      }
+      value_type borrow = 0;
+      for (size_type i = 0; i < an; i++) {
+        const wide_type d = static_cast<wide_type>(a[i]) -
+                            (i < bn ? b[i] : 0) - borrow;
+        result.store(i, static_cast<value_type>(d));
+        borrow = static_cast<value_type>(d >> (2 * BigInt::limb_bits - 1));
+      }
+    }
+    result.length_ = an + 1 < Limbs ? an + 1 : Limbs;
+    result.negative_ = negative;
+    result.normalize();
+    return result;
+  }
+
+public:
+  constexpr FixedBigInt() noexcept = default;
+  template <std::integral T> constexpr explicit FixedBigInt(T N) {
+    std::uintmax_t value = static_cast<std::uintmax_t>(N);
+    if constexpr (std::is_signed_v<T>)
+      if (N < T{0}) {
+        value = std::uintmax_t{0} - value;
+        negative_ = true;
+      }
+    length_ = 0;
+    do {
+      store(length_, static_cast<value_type>(value));
+      length_++;
+      value >>= BigInt::limb_bits;
+    } while (value);
+    normalize();
+  }
+  // 十进制，可以有开头的'-'，格式错误时抛出std::invalid_argument
+  constexpr explicit FixedBigInt(std::string_view text) {
+    const bool negative = !text.empty() && text.front() == '-';
+    if (negative)
+      text.remove_prefix(1);
+    if (text.empty())
+      throw std::invalid_argument{"empty FixedBigInt literal"};
+    // 每9位十进制数乘加一次
+    while (!text.empty()) {
+      const size_type n = text.size() < 9 ? text.size() : 9;
+      value_type chunk = 0, scale = 1;
+      for (const char c : text.substr(0, n)) {
+        if (c < '0' || c > '9')
+          throw std::invalid_argument{"invalid FixedBigInt literal"};
+        chunk = chunk * 10 + static_cast<value_type>(c - '0');
+        scale *= 10;
+      }
+      mul_add(scale, chunk);
+      text.remove_prefix(n);
+    }
+    negative_ = negative;
+    normalize();
+  }
+  // 扩大容量的转换是隐式的，缩小容量时放不下则抛出std::overflow_error
+  template <std::size_t M>
+  constexpr explicit(M > Limbs) FixedBigInt(const FixedBigInt<M> &N)
+      : length_{N.length_}, negative_{N.negative_} {
+    for (size_type i = 0; i < N.length_; i++)
+      store(i, N.limbs_[i]);
+  }
+
+  [[nodiscard]] constexpr auto limbs() const noexcept
+      -> std::span<const value_type> {
+    return {limbs_, length_};
+  }
+  [[nodiscard]] constexpr auto is_negative() const noexcept -> bool {
+    return negative_;
+  }
+  [[nodiscard]] constexpr auto is_zero() const noexcept -> bool {
+    return length_ == 1 && !limbs_[0];
+  }
+  // 视图引用本对象的limb，static constexpr常量的视图在整个程序运行期间有效
+  constexpr operator BigIntView() const noexcept {
+    return BigIntView{limbs(), negative_};
+  }
+  [[nodiscard]] auto to_string() const -> std::string {
+    return BigIntView{*this}.to_string();
+  }
+  friend auto operator<<(std::ostream &out, const FixedBigInt &N)
+      -> std::ostream & {
+    return out << BigIntView{N};
+  }
+
+  constexpr auto operator-() const noexcept -> FixedBigInt {
+    FixedBigInt result{*this};
+    result.negative_ = !negative_;
+    result.normalize();
+    return result;
+  }
+  template <std::size_t M>
+  constexpr auto operator+=(const FixedBigInt<M> &N) -> FixedBigInt & {
+    return *this = FixedBigInt{*this + N};
+  }
+  template <std::size_t M>
+  constexpr auto operator-=(const FixedBigInt<M> &N) -> FixedBigInt & {
+    return *this = FixedBigInt{*this - N};
+  }
+  template <std::size_t M>
+  constexpr auto operator*=(const FixedBigInt<M> &N) -> FixedBigInt & {
+    return *this = FixedBigInt{*this * N};
+  }
+  // 平方-乘，结果放不下时抛出std::overflow_error；最后一次乘方之后不再平方，不会提前溢出
+  friend constexpr auto pow(FixedBigInt base, size_type exponent)
+      -> FixedBigInt {
+    FixedBigInt result{1};
+    for (;;) {
+      if (exponent & 1)
+        result *= base;
+      exponent >>= 1;
+      if (!exponent)
+        return result;
+      base *= base;
+    }
+  }
+  template <std::size_t M>
+  constexpr auto operator==(const FixedBigInt<M> &N) const noexcept -> bool {
+    return (*this <=> N) == 0;
+  }
+};
+
+// 由字符串字面量推断容量：n位十进制数不超过n*log2(10) < n*3.322位
+template <std::size_t N>
+FixedBigInt(const char (&)[N]) -> FixedBigInt<(N * 3322 / 1000) / 32 + 1>;
+
+template <std::size_t L, std::size_t M>
+constexpr auto operator+(const FixedBigInt<L> &A, const FixedBigInt<M> &B)
+    -> FixedBigInt<(L > M ? L : M) + 1> {
+  return FixedBigInt<(L > M ? L : M) + 1>::signed_sum(A, B, B.negative_);
+}
+template <std::size_t L, std::size_t M>
+constexpr auto operator-(const FixedBigInt<L> &A, const FixedBigInt<M> &B)
+    -> FixedBigInt<(L > M ? L : M) + 1> {
+  return FixedBigInt<(L > M ? L : M) + 1>::signed_sum(A, B, !B.negative_);
+}
+// 逐limb相乘，中间结果a*b+r+carry不超过64位
+template <std::size_t L, std::size_t M>
+constexpr auto operator*(const FixedBigInt<L> &A, const FixedBigInt<M> &B)
+    -> FixedBigInt<L + M> {
+  using wide_type = BigInt::wide_type;
+  FixedBigInt<L + M> result;
+  for (std::size_t i = 0; i < A.length_; i++) {
+    wide_type carry = 0;
+    for (std::size_t j = 0; j < B.length_; j++) {
+      carry += static_cast<wide_type>(A.limbs_[i]) * B.limbs_[j] +
+               result.limbs_[i + j];
+      result.limbs_[i + j] = static_cast<BigInt::value_type>(carry);
+      carry >>= BigInt::limb_bits;
+    }
+    result.limbs_[i + B.length_] = static_cast<BigInt::value_type>(carry);
+  }
+  result.length_ = A.length_ + B.length_;
+  result.negative_ = A.negative_ != B.negative_;
+  result.normalize();
+  return result;
+}
+template <std::size_t L, std::size_t M>
+constexpr auto operator<=>(const FixedBigInt<L> &A,
+                           const FixedBigInt<M> &B) noexcept
+    -> std::strong_ordering {
+  if (A.negative_ != B.negative_)
+    return A.negative_ ? std::strong_ordering::less
+                       : std::strong_ordering::greater;
+  int result = FixedBigInt<L>::cmp_abs(A.limbs_, A.length_, B.limbs_,
+                                       B.length_);
+  if (A.negative_)
+    result = -result;
+  return result <=> 0;
+}
+
+// 只读映射整个文件，POSIX系统上用mmap，打开时不读取数据，访问时按页调入
+// 其他系统上退化为一次读入内存；打开失败时抛出std::runtime_error
+// 由view得到的视图引用映射的内存，不能比mapped_file活得更久
+class BigInt::mapped_file {
+  const std::byte *data_ = nullptr;
+  size_type size_ = 0;
+  // 不能映射时读入的副本
+  std::unique_ptr<std::byte[]> buffer_;
+
+public:
+  explicit mapped_file(const std::filesystem::path &path);
+  ~mapped_file();
+  mapped_file(mapped_file &&other) noexcept;
+  auto operator=(mapped_file &&other) noexcept -> mapped_file &;
+  [[nodiscard]] auto bytes() const noexcept -> std::span<const std::byte> {
+    return {data_, size_};
+  }
+  // 从offset开始的一个数，offset必须是4的倍数
+  [[nodiscard]] auto view(size_type offset = 0) const -> BigIntView;
+};
+
+#ifdef __cpp_lib_format
+// 填充、对齐和宽度与字符串相同，例如std::format("{:>40}", x)
+template <>
+struct std::formatter<BigInt> : std::formatter<std::string_view> {
+  template <class FormatContext>
+  auto format(const BigInt &N, FormatContext &ctx) const {
+    // 短数字不分配内存
+    char small[256];
+    if (const auto [end, ec] = to_chars(small, small + sizeof(small), N);
+        ec == std::errc{})
+      return std::formatter<std::string_view>::format(
+          std::string_view{small, end}, ctx);
+    return std::formatter<std::string_view>::format(N.to_string(), ctx);
+  }
+};
+#endif
+
+// 整数类型需要的limb个数
 template <std::integral T>
 [[nodiscard]] consteval size_t BigInt::get_initial_size() noexcept {
   static_assert(sizeof(T) <= size_t{8}, "uknow int type ,add it to code");
-  switch (sizeof(T)) {
-  case 1:
-    return 3;
-  case 2:
-    return 5;
-  case 3:
-    return 8;
-  case 4:
-    return 10;
-  case 5:
-    return 13;
-  case 6:
-    return 15;
-  case 7:
-    return 17;
-  case 8:
-    return 20;
-    // default:
-    //   return 20;
-  }
+  return (sizeof(T) + sizeof(value_type) - 1) / sizeof(value_type);
 }
 
 template <typename T>
@@ -283,8 +1273,10 @@ auto BigInt::divide_integer(T N) const -> bigInt_division_result {
 template <typename T>
   requires std::integral<T> && std::is_signed_v<T>
 auto BigInt::divide_integer(T N) const -> bigInt_division_result {
-  return divide_integer_uint(static_cast<std::uintmax_t>(std::abs(N)), N < T{0},
-                             initial_size<T>);
+  return divide_integer_uint(
+      N < T{0} ? std::uintmax_t{0} - static_cast<std::uintmax_t>(N)
+               : static_cast<std::uintmax_t>(N),
+      N < T{0}, initial_size<T>);
 }
 
-#endif //  MY_BIGINT_H
\ No newline at end of file
+#endif //  MY_BIGINT_H
@@ -1,76 +1,93 @@
 // my_bigint.cpp
 #include "my_bigint.h"
+#include "my_bigint_kernels.h"
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <utility>
 
+using namespace my_bigint_detail;
+
 BigInt::BigInt(std::uintmax_t initialValue, const size_type _size,
                const bool _negative) noexcept
-    : size_{_size}, length_{1},
-      array_{new value_type[std::max(size_, size_type{1})]},
-      negative_{_negative} {
+    : size_{std::max({_size, inline_capacity})}, length_{1}, array_{inline_},
+      negative_{_negative}, resource_{default_resource()} {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::construct, size_};
+  if (size_ > inline_capacity)
+    array_ = allocate(size_);
+  array_[0] = 0;
   if (!initialValue) { // 无初始值的构造
-    if (size_ < 1)
-      size_ = 1;
-    array_[0] = 0;
+    negative_ = false;
     return;
   }
   size_type i = 0;
   while (initialValue) {
-    array_[i++] = initialValue % 10;
-    initialValue /= 10;
+    array_[i++] = static_cast<value_type>(initialValue);
+    initialValue >>= limb_bits;
   }
   this->getLength(i);
 }
 BigInt::BigInt(const BigInt &N) noexcept
-    : size_(N.size_), length_(N.length_), array_(new value_type[N.size_]),
-      negative_(N.negative_) {
+    : size_(std::max(N.length_, inline_capacity)), length_(N.length_),
+      array_(inline_), negative_(N.negative_), resource_(default_resource()) {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::construct, length_};
+  record_copy();
+  if (size_ > inline_capacity)
+    array_ = allocate(size_);
   std::memcpy(array_, N.array_, length_ * sizeof(value_type));
 }
 
 BigInt::BigInt(BigInt &&N) noexcept
-    : size_(N.size_), length_(N.length_),
-      array_(std::exchange(N.array_, nullptr)), negative_(N.negative_) {}
-
-BigInt::BigInt(std::string_view initialValue)
-    : size_(initialValue.size()), length_(initialValue.size()),
-      array_(new value_type[std::max(size_, size_type{1})]) {
-  if (!size_) { // 处理空字符串的特殊情况
-    size_ = 1;
-    length_ = 1;
-    array_[0] = 0;
-    return;
+    : size_(N.size_), length_(N.length_), array_(N.array_),
+      negative_(N.negative_), resource_(N.resource_) {
+  // 内联数据只能复制
+  if (N.is_inline()) {
+    array_ = inline_;
+    std::memcpy(inline_, N.inline_, length_ * sizeof(value_type));
   }
-  if (initialValue.front() == '-') {
-    negative_ = true;
+  N.reset_inline();
+}
+
+BigInt::BigInt(std::string_view initialValue) : BigInt() {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::construct, initialValue.size() / 9 + 1};
+  bool negative = false;
+  if (!initialValue.empty() && initialValue.front() == '-') {
+    negative = true;
     initialValue.remove_prefix(1); // 删除开头的‘-’号
-    --length_;
-    array_[0] = 0; // 避免字符串为单‘-’的情况
   }
   // 调试时检测初始字符串是否为数字
   assert(std::all_of(initialValue.cbegin(), initialValue.cend(), isdigit));
   // 运行时检测初始字符串是否都是数字
   if (!std::all_of(initialValue.cbegin(), initialValue.cend(), isdigit)) {
-    delete[] array_;
-    array_ = nullptr;
     throw std::invalid_argument("string is't pure digtil");
   }
-  // 字符串大端序，转小端序bigint需要逆序遍历
-  std::transform(initialValue.crbegin(), initialValue.crend(), this->begin(),
-                 [](char x) -> value_type { return x - '0'; });
-  this->getLength(length_);
+  if (!initialValue.empty())
+    *this = from_decimal(initialValue);
+  negative_ = negative;
+  un_negative_zero();
 }
 auto BigInt::operator=(const BigInt &N) & noexcept -> BigInt & {
   if (this == &N)
     return *this;
-  if (size_ < N.size_)
-    return *this = BigInt{N};
+  record_copy();
+  if (size_ < N.length_) {
+    value_type *grown = allocate(N.length_);
+    deallocate();
+    array_ = grown;
+    size_ = N.length_;
+  }
   negative_ = N.negative_;
   length_ = N.length_;
   std::memcpy(array_, N.array_, length_ * sizeof(value_type));
@@ -79,52 +96,51 @@ auto BigInt::operator=(const BigInt &N) & noexcept -> BigInt & {
 auto BigInt::operator=(BigInt &&N) & noexcept -> BigInt & {
   if (this == &N)
     return *this;
+  // 内联数据和其他资源上的数组不能接管，只能复制
+  if (N.is_inline() ||
+      (resource_ != N.resource_ && !resource_->is_equal(*N.resource_)))
+    return *this = static_cast<const BigInt &>(N);
+  deallocate();
   length_ = N.length_;
   size_ = N.size_;
   negative_ = N.negative_;
-  if (array_)
-    delete[] array_;
-  array_ = std::exchange(N.array_, nullptr);
+  array_ = N.array_;
+  N.reset_inline();
   return *this;
 }
-auto BigInt::divide_integer_uint(std::uintmax_t N, bool N_is_negative,
-                                 std::size_t type_size) const
-    -> bigInt_division_result {
-  if (Is_zero()) {
-    return bigInt_division_result{};
-  }
-  if (!N) {
-    throw std::invalid_argument{"can't divide by zero"};
-  }
-  std::uintmax_t remainder{0};
-  BigInt quotient(0, this->length_);
-  for (size_type i = this->length_; i-- > 0;) {
-    remainder = (remainder * 10) + this->array_[i];
-    if (remainder < N)
-      quotient[i] = 0;
-    else {
-      quotient[i] = remainder / N;
-      remainder %= N;
-    }
-  }
-  quotient.negative_ = (negative_ != N_is_negative);
-  quotient.getLength(quotient.size_);
-
-  return bigInt_division_result{quotient,
-                                BigInt{remainder, type_size, this->negative_}};
+namespace {
+auto current_resource() noexcept -> std::pmr::memory_resource *& {
+  thread_local std::pmr::memory_resource *resource =
+      std::pmr::new_delete_resource();
+  return resource;
+}
+} // namespace
+auto BigInt::default_resource() noexcept -> std::pmr::memory_resource * {
+  return current_resource();
+}
+auto BigInt::set_default_resource(std::pmr::memory_resource *resource) noexcept
+    -> std::pmr::memory_resource * {
+  return std::exchange(current_resource(),
+                       resource ? resource : std::pmr::new_delete_resource());
+}
+auto BigInt::allocate(size_type n) const -> value_type * {
+  record_allocation(n * sizeof(value_type));
+  return static_cast<value_type *>(
+      resource_->allocate(n * sizeof(value_type), alignof(value_type)));
+}
+auto BigInt::deallocate() noexcept -> void {
+  if (!is_inline())
+    resource_->deallocate(array_, size_ * sizeof(value_type),
+                          alignof(value_type));
 }
-
 auto BigInt::fillZero() -> void {
   std::fill(array_, array_ + size_, 0);
   length_ = 1;
   negative_ = false;
 }
 auto BigInt::getLength(const size_type maxlength) -> size_type {
-  for (length_ = maxlength; array_[length_ - 1] == 0 && length_ > 1; length_--)
-    ;
+  length_ = normalized_length(array_, maxlength);
   un_negative_zero();
-  // 断言出现错误说明其他地方实现存在问题
-  assert(std::all_of(begin(), end(), [](auto x) { return 0 <= x && x <= 9; }));
   return length_;
 }
 auto BigInt::un_negative_zero() -> bool {
@@ -140,49 +156,64 @@ auto BigInt::un_negative_zero() -> bool {
   }
   return false;
 }
-[[nodiscard]] auto BigInt::pow_of_ten(const std::intmax_t n) const -> BigInt {
-  if (!n) {
-    return BigInt{*this};
+auto BigInt::ten_pow(size_type n) -> BigInt {
+  BigInt result{1}, base{10};
+  for (; n; n >>= 1) {
+    if (n & 1)
+      result = result * base;
+    if (n > 1)
+      base = base.square();
   }
-  if (n < 0 && static_cast<size_type>(-n) >= this->length_) {
-    return BigInt{0};
+  return result;
+}
+auto BigInt::limb_shift(std::intmax_t k) const -> BigInt {
+  if (!k || Is_zero())
+    return BigInt{*this};
+  if (k < 0) {
+    const size_type drop = static_cast<size_type>(-k);
+    if (drop >= length_)
+      return BigInt{0};
+    BigInt result{from_limbs(array_ + drop, length_ - drop)};
+    result.negative_ = negative_;
+    return result;
   }
-  BigInt result(0, length_ + n);
-  // （result.zise_，max(0,n）】段赋值为（this->sise_-n，max(-n,0)】
-  // （max(0-n,0)，0】段赋值为0  lenth=this->size_-n-max(0-n,0)
-  //
-
-  const size_type begin_copy = n > 0 ? static_cast<size_type>(n) : 0;
-  const size_type copy_length = result.size_ - begin_copy;
-  if (copy_length) {
-    const size_type origin_begin = n < 0 ? static_cast<size_type>(-n) : 0;
-    std::memcpy(result.array_ + begin_copy, this->array_ + origin_begin,
-                (copy_length) * sizeof(value_type));
+  const size_type add = static_cast<size_type>(k);
+  BigInt result(0, length_ + add);
+  std::fill(result.array_, result.array_ + add, 0);
+  std::memcpy(result.array_ + add, array_, length_ * sizeof(value_type));
+  result.length_ = length_ + add;
+  result.negative_ = negative_;
+  return result;
+}
+auto BigInt::abs_shift(std::intmax_t bits) const -> BigInt {
+  const std::intmax_t limbs = bits / limb_bits;
+  const int rest = static_cast<int>(bits % limb_bits);
+  BigInt result{limb_shift(limbs)};
+  if (!rest || result.Is_zero())
+    return result;
+  if (rest > 0) {
+    BigInt shifted(0, result.length_ + 1);
+    shifted[result.length_] =
+        lshift(shifted.array_, result.array_, result.length_, rest);
+    shifted.negative_ = negative_;
+    shifted.getLength(result.length_ + 1);
+    return shifted;
   }
-  if (begin_copy)
-    std::fill(result.array_, result.array_ + begin_copy, 0);
-
-  // 原始版本
-  // （result.zise_，max(0,n）】段赋值为（this->sise_-n，max(0-n,0)】
-  // （max(0-n,0)，0】段赋值为0
-
-  // // size_type j = std::max(n, static_cast<std::intmax_t>(0));
-  // for (size_type i = result.size_; i-- != 0;)
-  //   // result[i] = (i >= j) ? this->array_[i - n] : 0;
-  //   result[i] = std::cmp_greater_equal(i, n) ? this->array_[i - n] : 0;
-  // // result[i] = ((i <=> n) >= 0) ? this->array_[i - n] : 0;
-
-  result.getLength(result.size_);
+  rshift(result.array_, result.array_, result.length_, -rest);
+  result.getLength(result.length_);
   return result;
 }
-auto BigInt::back_inserter(const value_type n) -> BigInt {
-  // 如果断言失败说明其他地方实现有问题
-  assert(length_ < size_);
-  for (size_type i = length_; i-- > 0;)
-    array_[i + 1] = array_[i];
-  array_[0] = n;
-  getLength(length_ + 1);
-  return *this;
+auto BigInt::low_limbs(size_type k) const -> BigInt {
+  return from_limbs(array_, std::min(k, length_));
+}
+[[nodiscard]] auto BigInt::pow_of_ten(const std::intmax_t n) const -> BigInt {
+  if (!n) {
+    return BigInt{*this};
+  }
+  if (n > 0)
+    return *this * ten_pow(static_cast<size_type>(n));
+  // 除法向0取整，与按十进制位截断一致
+  return *this / ten_pow(static_cast<size_type>(-n));
 }
 auto BigInt::operator-() const -> BigInt {
   if (Is_zero()) {
@@ -198,51 +229,21 @@ auto BigInt::abs(const BigInt &N) -> BigInt {
   return temp;
 }
 auto BigInt::absAdd(const BigInt &N) const -> BigInt {
-  BigInt result(0, std::max(length_, N.length_) + 1);
-  value_type temp = 0;
-  for (size_type i = 0; i < result.size_; i++) {
-    temp =
-        temp / 10 + (i < length_ ? array_[i] : 0) + (i < N.length_ ? N[i] : 0);
-    result[i] = temp % 10;
-  }
-  result.getLength(result.size_);
+  const BigInt &longer = length_ < N.length_ ? N : *this;
+  const BigInt &shorter = length_ < N.length_ ? *this : N;
+  BigInt result(0, longer.length_ + 1);
+  result[longer.length_] = add_n(result.array_, longer.array_, longer.length_,
+                                 shorter.array_, shorter.length_);
+  result.getLength(longer.length_ + 1);
   return result;
 }
 auto BigInt::absSub(const BigInt &N) const -> BigInt {
-  if (cmp_abs_equal(*this, N)) // 相等直接输出0，避免减法产生负0
-    // return BigInt(0, 1);//为了优化除法，改成如下形式
-    return BigInt(0, size_);
-  // BigInt result(0, length);//为了优化除法，改成如下形式
-  BigInt result(0, size_);
-  value_type temp = 0;
-  // 优化0.03秒
-  temp = array_[0] - N[0];
-  for (size_type i = 0; i < length_;) // 大减去小,所以用this的长度
-  {
-    // 1.08s，编译器优化前，下面代码最快
-    // if (temp < 0)
-    // {
-    //   result[i++] = temp + 10;
-    //   temp = (i < N.length ? array[i] - N[i] : array[i]) - 1;
-    // }
-    // else
-    // {
-    //   result[i++] = temp;
-    //   temp = i < N.length ? array[i] - N[i] : array[i];
-    // }
-
-    // 1.09,编译器优化后，下面代码最快
-    result[i++] = (temp < 0) ? (temp + 10) : temp;
-    temp = (i < N.length_ ? array_[i] - N[i] : array_[i]) - (temp < 0 ? 1 : 0);
-  }
-
-  // 原始版本// 优化前1.11
-  // for (size_type i = 0; i < length; i++) // 大减去小,所以用this的长度
-  // {
-  //   temp = array[i] - (i < N.length ? N[i] : 0) + (temp < 0 ? -1 : 0);
-  //   result[i] = temp + (temp < 0 ? 10 : 0);
-  // }
-
+  BigInt result(0, length_);
+  // 大减去小,所以用this的长度
+  [[maybe_unused]] const value_type borrow =
+      sub_n(result.array_, array_, length_, N.array_, N.length_);
+  // 如果断言失败说明调用时没有保证大减小
+  assert(!borrow);
   result.getLength(length_);
   return result;
 }
@@ -266,54 +267,243 @@ auto BigInt::samNAdd(const BigInt &N) const -> BigInt {
   result.un_negative_zero(); // 防止-0
   return result;
 }
-auto BigInt::divide(const BigInt &N) const -> bigInt_division_result {
-  // 大整数之间除法，效率很低
-  if (N.Is_zero()) {
-    throw std::invalid_argument{"can't divide by zero"};
-  }
-  // 被除数更大的时候直接返回0
-  if (this->cmp_abs_less(N))
-    return bigInt_division_result{}; // 可能在内部调用时造成泄露?
-  // 针对求pi函数优化
-  if (N == BigInt("10000000000")) {
-    BigInt remainder{0, 10};
-    std::copy(this->array_, this->array_ + 10, remainder.array_);
-    return bigInt_division_result{this->pow_of_ten(-10), remainder};
-  }
+namespace {
+// 原地乘法需要先保存一个乘数，线程内复用，只增不减
+// mul_limbs中的Toom-3会再次进入原地乘法，嵌套时改为临时分配
+class multiply_scratch {
+  struct shared_buffer {
+    std::unique_ptr<limb_t[]> data;
+    size_type capacity = 0;
+    bool busy = false;
+  };
+  static thread_local shared_buffer shared_;
+  std::unique_ptr<limb_t[]> own_;
+  limb_t *data_;
 
-  // 下面除法最好重写,效率过低
-  BigInt quotient(0, length_ - N.length_ + 1),
-      remainder(0, N.length_ + 1); // （1）余数为正
-  quotient.fillZero();
-  for (size_type i = length_; i-- > 0;) // T(9n)
-  {
-    remainder.back_inserter(array_[i]);
-    // 如果后面的减法运算重置remainder的容量，造成内存溢出错误
-    while (!remainder.cmp_abs_less(N)) {
-      // 减法需要重新开辟空间，不合算，考虑二分查找猜被除数
-      remainder = remainder.absSub(N);
-      // 涉及到减法，所以之前要将涉及的数全部转换为正数计算（1）
-      ++quotient[i];
+public:
+  explicit multiply_scratch(size_type n) {
+    if (shared_.busy) {
+      own_ = std::make_unique_for_overwrite<limb_t[]>(n);
+      record_allocation(n * sizeof(limb_t));
+      data_ = own_.get();
+      return;
     }
+    if (shared_.capacity < n) {
+      shared_.capacity = std::max(n, 2 * shared_.capacity);
+      shared_.data = std::make_unique_for_overwrite<limb_t[]>(shared_.capacity);
+      record_allocation(shared_.capacity * sizeof(limb_t));
+    }
+    shared_.busy = true;
+    data_ = shared_.data.get();
+  }
+  ~multiply_scratch() {
+    if (!own_)
+      shared_.busy = false;
   }
-  quotient.negative_ = (negative_ != N.negative_); // 同号为正
-  quotient.getLength(quotient.size_);
-  remainder.negative_ = this->negative_;
-  return bigInt_division_result{quotient, remainder};
+  multiply_scratch(const multiply_scratch &) = delete;
+  auto operator=(const multiply_scratch &) -> multiply_scratch & = delete;
+  [[nodiscard]] auto get() const noexcept -> limb_t * { return data_; }
+};
+thread_local multiply_scratch::shared_buffer multiply_scratch::shared_;
+// 整数拆成limb，返回limb个数，至少为1
+auto split_limbs(std::uintmax_t N, limb_t *limbs) -> size_type {
+  size_type n = 0;
+  do {
+    limbs[n++] = static_cast<limb_t>(N);
+    N >>= limb_bits;
+  } while (N);
+  return n;
+}
+} // namespace
+auto BigInt::reserve(size_type n) -> void {
+  if (size_ >= n)
+    return;
+  const size_type capacity = std::max(n, 2 * size_);
+  value_type *grown = allocate(capacity);
+  std::memcpy(grown, array_, length_ * sizeof(value_type));
+  deallocate();
+  array_ = grown;
+  size_ = capacity;
+}
+auto BigInt::add_in_place(const value_type *b, size_type bn, bool b_negative)
+    -> void {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::add, std::max(length_, bn)};
+  const bool aliased = b == array_;
+  if (Is_zero())
+    negative_ = b_negative;
+  if (negative_ == b_negative) {
+    const size_type n = std::max(length_, bn);
+    reserve(n + 1);
+    if (aliased)
+      b = array_;
+    std::fill(array_ + length_, array_ + n, 0);
+    array_[n] = add_n(array_, array_, n, b, bn);
+    getLength(n + 1);
+    return;
+  }
+  // 异号，绝对值大减小，自身相减一定走第一个分支
+  if (length_ > bn || (length_ == bn && cmp_n(array_, b, bn) >= 0)) {
+    sub_n(array_, array_, length_, b, bn);
+    getLength(length_);
+    return;
+  }
+  reserve(bn);
+  std::fill(array_ + length_, array_ + bn, 0);
+  sub_n(array_, b, bn, array_, bn);
+  negative_ = b_negative;
+  getLength(bn);
+}
+auto BigInt::mul_in_place(const value_type *b, size_type bn, bool b_negative)
+    -> void {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::multiply, std::max(length_, bn)};
+  const bool negative = negative_ != b_negative;
+  if (Is_zero())
+    return;
+  if (bn == 1) {
+    const value_type m = b[0];
+    reserve(length_ + 1);
+    array_[length_] = mul_1(array_, array_, length_, m);
+    negative_ = negative;
+    getLength(length_ + 1);
+    return;
+  }
+  // 结果直接写入array_，原值先复制出来
+  const size_type an = length_;
+  const multiply_scratch scratch(an);
+  value_type *a = scratch.get();
+  std::memcpy(a, array_, an * sizeof(value_type));
+  if (b == array_)
+    b = a;
+  reserve(an + bn);
+  if (an >= bn)
+    mul_limbs(array_, a, an, b, bn);
+  else
+    mul_limbs(array_, b, bn, a, an);
+  negative_ = negative;
+  getLength(an + bn);
+}
+auto BigInt::add_in_place(std::uintmax_t N, bool N_is_negative) -> void {
+  value_type limbs[initial_size<std::uintmax_t>];
+  add_in_place(limbs, split_limbs(N, limbs), N_is_negative);
+}
+auto BigInt::mul_in_place(std::uintmax_t N, bool N_is_negative) -> void {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::multiply, length_};
+  if (N <= std::numeric_limits<value_type>::max()) {
+    const value_type limb = static_cast<value_type>(N);
+    mul_in_place(&limb, 1, N_is_negative);
+    return;
+  }
+  const bool negative = negative_ != N_is_negative;
+  reserve(length_ + 2);
+  const wide_type carry = mul_1_wide(array_, array_, length_, N);
+  array_[length_] = static_cast<value_type>(carry);
+  array_[length_ + 1] = static_cast<value_type>(carry >> limb_bits);
+  negative_ = negative;
+  getLength(length_ + 2);
+}
+auto BigInt::add_integral(std::uintmax_t N, bool N_is_negative) const
+    -> BigInt {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::add, length_};
+  value_type limbs[initial_size<std::uintmax_t>];
+  const size_type bn = split_limbs(N, limbs);
+  if (Is_zero())
+    return BigInt{N, bn, N_is_negative};
+  if (negative_ == N_is_negative) {
+    const size_type n = std::max(length_, bn);
+    BigInt result(0, n + 1);
+    result[n] = length_ >= bn
+                    ? add_n(result.array_, array_, length_, limbs, bn)
+                    : add_n(result.array_, limbs, bn, array_, length_);
+    result.negative_ = negative_;
+    result.getLength(n + 1);
+    return result;
+  }
+  // 异号，绝对值大减小
+  if (length_ > bn || (length_ == bn && cmp_n(array_, limbs, bn) >= 0)) {
+    BigInt result(0, length_);
+    sub_n(result.array_, array_, length_, limbs, bn);
+    result.negative_ = negative_;
+    result.getLength(length_);
+    return result;
+  }
+  // |this| < N，自身也能放进整数
+  return BigInt{N - low_word(), bn, N_is_negative};
+}
+auto BigInt::mul_integral(std::uintmax_t N, bool N_is_negative) const
+    -> BigInt {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::multiply, length_};
+  if (!N || Is_zero())
+    return BigInt{0};
+  BigInt result(0, length_ + 2);
+  if (N <= std::numeric_limits<value_type>::max()) {
+    result[length_] =
+        mul_1(result.array_, array_, length_, static_cast<value_type>(N));
+    result.getLength(length_ + 1);
+  } else {
+    const wide_type carry = mul_1_wide(result.array_, array_, length_, N);
+    result[length_] = static_cast<value_type>(carry);
+    result[length_ + 1] = static_cast<value_type>(carry >> limb_bits);
+    result.getLength(length_ + 2);
+  }
+  result.negative_ = negative_ != N_is_negative;
+  return result;
+}
+auto BigInt::cmp_integral(std::uintmax_t N, bool N_is_negative) const noexcept
+    -> int {
+  // 负数不为0，异号时直接由符号决定
+  if (negative_ != N_is_negative)
+    return negative_ ? -1 : 1;
+  // 同号比较绝对值，负数结果取反
+  int result = 1;
+  if (length_ <= initial_size<std::uintmax_t>) {
+    const std::uintmax_t value = low_word();
+    result = value < N ? -1 : (value > N ? 1 : 0);
+  }
+  return negative_ ? -result : result;
+}
+auto BigInt::operator+=(const BigInt &N) -> BigInt & {
+  add_in_place(N.array_, N.length_, N.negative_);
+  return *this;
+}
+auto BigInt::operator-=(const BigInt &N) -> BigInt & {
+  add_in_place(N.array_, N.length_, !N.negative_);
+  return *this;
+}
+auto BigInt::operator*=(const BigInt &N) -> BigInt & {
+  mul_in_place(N.array_, N.length_, N.negative_);
+  return *this;
+}
+auto BigInt::operator/=(const BigInt &N) -> BigInt & {
+  divide_in_place(N, false);
+  return *this;
+}
+auto BigInt::operator%=(const BigInt &N) -> BigInt & {
+  divide_in_place(N, true);
+  return *this;
 }
-
 auto pow(const BigInt &N, const std::size_t &exponent) -> BigInt {
   // 针对求pi函数的优化
-  if (N == BigInt(10))
-    return N.pow_of_ten(exponent - 1);
-  BigInt result(1, N.length_ * exponent);
-  for (std::size_t i = 0; i < exponent; i++)
-    result *= N;
+  if (N == 10)
+    return BigInt::ten_pow(exponent);
+  // 从最高位开始，每一位平方一次，该位为1时再乘一次底数
+  BigInt result{1};
+  for (std::size_t bit = std::bit_floor(exponent); bit; bit >>= 1) {
+    result = result.square();
+    if (exponent & bit)
+      result *= N;
+  }
   return result;
 }
 
 auto BigInt::operator+(const BigInt &N) const -> BigInt {
   // O(n)// 处理同号加法，异号转变为同号减法
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::add, std::max(length_, N.length_)};
   if (N.Is_zero()) {
     return BigInt(*this);
   }
@@ -325,9 +515,11 @@ auto BigInt::operator+(const BigInt &N) const -> BigInt {
   return this->samNAdd(N);
 }
 auto BigInt::operator-(const BigInt &N) const -> BigInt {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::add, std::max(length_, N.length_)};
   // O(n) 处理同号减法，异号转变为同号加法
   if (N.Is_zero()) {
-    return BigInt{0};
+    return BigInt{*this};
   }
   if (Is_zero()) {
     BigInt result{N};
@@ -340,37 +532,24 @@ auto BigInt::operator-(const BigInt &N) const -> BigInt {
   return this->samNSub(N);
 }
 auto BigInt::operator*(const BigInt &N) const -> BigInt {
-  // O(n^2) //
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::multiply, std::max(length_, N.length_)};
+  // 按长度分级：O(n^2) basecase，O(n^1.58) Karatsuba，O(n^1.46) Toom-3，
+  // O(n log n) NTT
   if (N.Is_zero() || Is_zero()) {
     return BigInt{0};
   }
-  // 乘法结果长度最多为两乘数之和，最多进1位
+  if (this == &N)
+    return square();
+  // 乘法结果长度最多为两乘数之和
   BigInt result{0, length_ + N.length_};
-  result.fillZero();
-  value_type temp = 0;
-  // size_type s{0};
-  size_type i{0}, j{0};
-  for (i = 0; i < N.length_; i++) {
-    for (j = 0; j < length_; j++) {
-      temp = result[i + j] + temp / 10 + N[i] * array_[j];
-      // temp最大值为（9+9+9*9=99）<100,进位不会超过1位
-      result[i + j] = temp % 10;
-
-      // cout << "s,i" << i << "j" << j << "=" << (s = N[i] * array[j]) <<
-      // '\n'; cout << "temp=" << (s = temp) << '\n'; cout << "R" << i + j
-      // <<
-      // "=" << (s = temp % 10) << '\n' << '\n';
-    }
-    // result[i + j] = result[i + j] + temp / 10;
-    // 处理多余进位，因为前面的注释，进位最多不会超过1位，所以只需要处理1次
-    // i + j 位 从来没有被访问过，为0，优化如下
-    result[i + j] = temp / 10;
-    temp = 0;
-    // cout << "result=" << result << '\n';
-    // cout << "*************" << '\n';
-  }
+  // 按长度分级选择算法，要求第一个乘数较长
+  if (length_ >= N.length_)
+    mul_limbs(result.array_, array_, length_, N.array_, N.length_);
+  else
+    mul_limbs(result.array_, N.array_, N.length_, array_, length_);
 
-  result.getLength(result.size_);
+  result.getLength(length_ + N.length_);
   result.negative_ = (negative_ != N.negative_); // 同号为正
   return result;
 }
@@ -383,18 +562,12 @@ auto BigInt::operator%(const BigInt &N) const -> BigInt {
 auto BigInt::cmp_abs_equal(const BigInt &A, const BigInt &B) -> bool {
   if (A.length_ != B.length_)
     return false;
-  for (size_type i = 0; i < A.length_; i++)
-    if (A[i] != B[i])
-      return false;
-  return true;
+  return std::memcmp(A.array_, B.array_, A.length_ * sizeof(value_type)) == 0;
 }
 auto BigInt::cmp_abs_less(const BigInt &N) const -> bool {
   if (length_ < N.length_)
     return true;
   if (length_ > N.length_)
     return false;
-  for (size_type i = length_; i-- > 0;)
-    if (this->array_[i] != N[i])
-      return this->array_[i] < N[i];
-  return false;
-}
\ No newline at end of file
+  return cmp_n(array_, N.array_, length_) < 0;
+}
@@ -0,0 +1,119 @@
+// my_bigint_batch.cpp
+// 批量求和与求积：求和在64位累加器中逐limb相加，进位推迟到最后统一处理；
+// 求积用按长度平衡的乘积树，两侧操作数长度相近，快速乘法才能发挥作用
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include "my_bigint_parallel.h"
+#include <algorithm>
+#include <limits>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+using namespace my_bigint_detail;
+namespace {
+// 每个累加位不超过2^32-1，再加2^32-1个limb也不会溢出64位
+constexpr size_type deferred_additions = std::numeric_limits<limb_t>::max();
+// 乘积树中总长度不超过阈值的区间直接顺序相乘，与Karatsuba阈值相当
+constexpr size_type product_leaf_limbs = 32;
+
+// 每个累加位只保留低32位，进位加到高一位，最高位留有足够的空间
+auto propagate(std::vector<wide_t> &accumulator) -> void {
+  wide_t carry = 0;
+  for (wide_t &word : accumulator) {
+    word += carry;
+    carry = word >> limb_bits;
+    word = static_cast<limb_t>(word);
+  }
+}
+// 并行时存放子结果的对象从new/delete分配，工作线程的结果移动赋值时只交换指针，
+// 不会在其他线程使用调用方的arena，与mul_toom3相同
+auto make_holder() -> BigInt {
+  const BigInt::resource_scope scope{std::pmr::new_delete_resource()};
+  return BigInt{};
+}
+} // namespace
+
+auto BigInt::sum(std::span<const BigInt> values) -> BigInt {
+  // 总长度决定是否并行，最长的一个决定累加器的长度
+  size_type total = 0, n = 0;
+  for (const BigInt &v : values) {
+    total += v.length_;
+    n = std::max(n, v.length_);
+  }
+  [[maybe_unused]] const instrument_scope instrument{operation::add, total};
+  if (values.size() > 1 && parallel_enabled(total / 2)) {
+    const size_type half = values.size() / 2;
+    BigInt low{make_holder()}, high{make_holder()};
+    parallel_invoke([&] { low = sum(values.first(half)); },
+                    [&] { high = sum(values.subspan(half)); });
+    // 和是新构造的对象，回到调用方的默认资源上
+    return low + high;
+  }
+  // 正数和负数分别累加，最后相减一次
+  // 多留两个limb放累计的进位，2^64个数相加也放得下
+  std::vector<wide_t> positive(n + 2), negative(n + 2);
+  size_type pending = 0;
+  for (const BigInt &v : values) {
+    std::vector<wide_t> &accumulator = v.negative_ ? negative : positive;
+    for (size_type i = 0; i < v.length_; i++)
+      accumulator[i] += v.array_[i];
+    if (++pending == deferred_additions) {
+      propagate(positive);
+      propagate(negative);
+      pending = 0;
+    }
+  }
+  propagate(positive);
+  propagate(negative);
+  const auto to_bigint = [n](const std::vector<wide_t> &accumulator) {
+    BigInt result(0, n + 2);
+    std::copy(accumulator.begin(), accumulator.end(), result.array_);
+    result.getLength(n + 2);
+    return result;
+  };
+  BigInt result{to_bigint(positive)};
+  result -= to_bigint(negative);
+  return result;
+}
+
+auto BigInt::product(std::span<const BigInt> values) -> BigInt {
+  if (values.empty())
+    return BigInt{1};
+  if (std::any_of(values.begin(), values.end(),
+                  [](const BigInt &v) { return v.Is_zero(); }))
+    return BigInt{0};
+  size_type total = 0;
+  for (const BigInt &v : values)
+    total += v.length_;
+  [[maybe_unused]] const instrument_scope instrument{operation::multiply,
+                                                     total};
+  return product_tree(values, total);
+}
+auto BigInt::product_tree(std::span<const BigInt> values, size_type total)
+    -> BigInt {
+  if (values.size() == 1)
+    return values[0];
+  // 较短的区间顺序乘入同一个结果，乘数都很短，每次只是一遍mul_1量级的运算
+  if (total <= product_leaf_limbs) {
+    BigInt result{values[0]};
+    for (const BigInt &v : values.subspan(1))
+      result *= v;
+    return result;
+  }
+  // 按limb数对半分，长短悬殊的输入也能得到长度相近的两个子积
+  size_type split = 1, low_limbs = values[0].length_;
+  while (split + 1 < values.size() &&
+         2 * (low_limbs + values[split].length_) <= total)
+    low_limbs += values[split++].length_;
+  const std::span<const BigInt> low = values.first(split),
+                                high = values.subspan(split);
+  const size_type high_limbs = total - low_limbs;
+  if (parallel_enabled(std::min(low_limbs, high_limbs))) {
+    BigInt left{make_holder()}, right{make_holder()};
+    parallel_invoke([&] { left = product_tree(low, low_limbs); },
+                    [&] { right = product_tree(high, high_limbs); });
+    return left * right;
+  }
+  return product_tree(low, low_limbs) * product_tree(high, high_limbs);
+}
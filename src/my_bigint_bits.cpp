@@ -0,0 +1,272 @@
+// my_bigint_bits.cpp
+// 二进制位运算：移位、补码语义的按位运算、2的幂进制的字符串转换
+// limb本身就是二进制，这些运算都是一次遍历，不需要乘除
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace my_bigint_detail;
+namespace {
+constexpr char digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// 2的幂进制每位的二进制位数，10进制返回0，其他进制抛出异常
+auto radix_bits(int base) -> int {
+  if (base == 10)
+    return 0;
+  if (base < 2 || base > 32 ||
+      !std::has_single_bit(static_cast<unsigned>(base)))
+    throw std::invalid_argument{"base must be 10 or a power of two up to 32"};
+  return std::countr_zero(static_cast<unsigned>(base));
+}
+// 不是数字或字母时返回36，大于任何进制
+auto digit_value(char c) -> int {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'z')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'Z')
+    return c - 'A' + 10;
+  return 36;
+}
+// 二进制位数，0为0
+auto bit_length(const limb_t *a, size_type n) -> size_type {
+  return (n - 1) * limb_bits + static_cast<size_type>(std::bit_width(a[n - 1]));
+}
+// 2的幂进制的位数，0也有一位
+auto radix_digits(const limb_t *a, size_type n, int bits) -> size_type {
+  const auto k = static_cast<size_type>(bits);
+  return std::max<size_type>((bit_length(a, n) + k - 1) / k, 1);
+}
+// 右移时移出的低位是否有1，决定负数是否需要向负无穷进一
+auto any_bits_below(const limb_t *a, size_type limbs, int rest) -> bool {
+  if (std::any_of(a, a + limbs, [](limb_t x) { return x != 0; }))
+    return true;
+  return rest && (a[limbs] & ((limb_t{1} << rest) - 1)) != 0;
+}
+// 左移增加的整limb数；左移后的二进制位数超出size_type时抛出异常，
+// 各处按size_type计算位数，这一限制也保证limb数和字节数不会溢出
+auto shifted_limbs(size_type length, std::uintmax_t bits) -> size_type {
+  constexpr size_type max_limbs =
+      std::numeric_limits<size_type>::max() / limb_bits;
+  const std::uintmax_t limbs = bits / limb_bits;
+  if (limbs > max_limbs - length - 1)
+    throw std::length_error{"BigInt shift count too large"};
+  return static_cast<size_type>(limbs);
+}
+} // namespace
+
+auto BigInt::shift_left(std::uintmax_t bits) const -> BigInt {
+  if (Is_zero())
+    return BigInt{0};
+  const size_type limbs = shifted_limbs(length_, bits);
+  const int rest = static_cast<int>(bits % limb_bits);
+  const size_type n = length_ + limbs + 1;
+  // 移位数来自调用方，分配失败时由reserve抛出std::bad_alloc
+  BigInt result{0};
+  result.reserve(n);
+  std::fill(result.array_, result.array_ + limbs, 0);
+  if (rest) {
+    result[n - 1] = lshift(result.array_ + limbs, array_, length_, rest);
+  } else {
+    std::memcpy(result.array_ + limbs, array_, length_ * sizeof(value_type));
+    result[n - 1] = 0;
+  }
+  result.negative_ = negative_;
+  result.getLength(n);
+  return result;
+}
+auto BigInt::shift_right(std::uintmax_t bits) const -> BigInt {
+  // 全部移出，负数向负无穷取整为-1
+  if (bits / limb_bits >= length_)
+    return BigInt{negative_ ? -1 : 0};
+  const auto limbs = static_cast<size_type>(bits / limb_bits);
+  const int rest = static_cast<int>(bits % limb_bits);
+  const size_type n = length_ - limbs;
+  BigInt result(0, n);
+  if (rest)
+    rshift(result.array_, array_ + limbs, n, rest);
+  else
+    std::memcpy(result.array_, array_ + limbs, n * sizeof(value_type));
+  result.negative_ = negative_;
+  result.getLength(n);
+  if (negative_ && any_bits_below(array_, limbs, rest))
+    result.add_in_place(1, true);
+  return result;
+}
+auto BigInt::shift_left_in_place(std::uintmax_t bits) -> BigInt & {
+  if (Is_zero() || !bits)
+    return *this;
+  const size_type limbs = shifted_limbs(length_, bits);
+  const int rest = static_cast<int>(bits % limb_bits);
+  const size_type n = length_ + limbs + 1;
+  reserve(n);
+  // 从高位向低位搬移，目标在源之上，不会覆盖未读的limb
+  if (rest) {
+    array_[n - 1] = lshift(array_ + limbs, array_, length_, rest);
+  } else {
+    std::memmove(array_ + limbs, array_, length_ * sizeof(value_type));
+    array_[n - 1] = 0;
+  }
+  std::fill(array_, array_ + limbs, 0);
+  getLength(n);
+  return *this;
+}
+auto BigInt::shift_right_in_place(std::uintmax_t bits) -> BigInt & {
+  if (Is_zero() || !bits)
+    return *this;
+  if (bits / limb_bits >= length_) {
+    array_[0] = negative_ ? 1 : 0;
+    length_ = 1;
+    return *this;
+  }
+  const auto limbs = static_cast<size_type>(bits / limb_bits);
+  const int rest = static_cast<int>(bits % limb_bits);
+  const bool round_down = negative_ && any_bits_below(array_, limbs, rest);
+  const size_type n = length_ - limbs;
+  if (rest)
+    rshift(array_, array_ + limbs, n, rest);
+  else
+    std::memmove(array_, array_ + limbs, n * sizeof(value_type));
+  getLength(n);
+  if (round_down)
+    add_in_place(1, true);
+  return *this;
+}
+
+template <class Op>
+auto BigInt::bitwise(const BigInt &N, bool negative, Op op) const -> BigInt {
+  // 多一个limb放补码的符号位，负数结果的绝对值也不会超出
+  const size_type n = std::max(length_, N.length_) + 1;
+  BigInt result(0, n);
+  // 负数的补码为~|x|+1，逐limb传递加1的进位；负数结果再取一次补码得到绝对值
+  limb_t carry_a = negative_, carry_b = N.negative_, carry_r = negative;
+  for (size_type i = 0; i < n; i++) {
+    limb_t a = i < length_ ? array_[i] : 0;
+    limb_t b = i < N.length_ ? N.array_[i] : 0;
+    if (negative_) {
+      a = ~a + carry_a;
+      carry_a = carry_a && a == 0;
+    }
+    if (N.negative_) {
+      b = ~b + carry_b;
+      carry_b = carry_b && b == 0;
+    }
+    limb_t r = op(a, b);
+    if (negative) {
+      r = ~r + carry_r;
+      carry_r = carry_r && r == 0;
+    }
+    result.array_[i] = r;
+  }
+  result.negative_ = negative;
+  result.getLength(n);
+  return result;
+}
+auto BigInt::operator&(const BigInt &N) const -> BigInt {
+  return bitwise(N, negative_ && N.negative_,
+                 [](limb_t a, limb_t b) { return a & b; });
+}
+auto BigInt::operator|(const BigInt &N) const -> BigInt {
+  return bitwise(N, negative_ || N.negative_,
+                 [](limb_t a, limb_t b) { return a | b; });
+}
+auto BigInt::operator^(const BigInt &N) const -> BigInt {
+  return bitwise(N, negative_ != N.negative_,
+                 [](limb_t a, limb_t b) { return a ^ b; });
+}
+auto BigInt::operator~() const -> BigInt {
+  BigInt result{*this};
+  result += 1;
+  result.negative_ = !result.negative_;
+  result.un_negative_zero();
+  return result;
+}
+auto BigInt::operator&=(const BigInt &N) -> BigInt & {
+  return *this = *this & N;
+}
+auto BigInt::operator|=(const BigInt &N) -> BigInt & {
+  return *this = *this | N;
+}
+auto BigInt::operator^=(const BigInt &N) -> BigInt & {
+  return *this = *this ^ N;
+}
+
+auto to_chars(char *first, char *last, const BigInt &N, int base)
+    -> std::to_chars_result {
+  const int bits = radix_bits(base);
+  if (!bits)
+    return to_chars(first, last, N);
+  const size_type digits = radix_digits(N.array_, N.length_, bits);
+  const size_type sign = N.negative_ ? 1 : 0;
+  if (static_cast<size_type>(last - first) < sign + digits)
+    return {last, std::errc::value_too_large};
+  if (sign)
+    *first++ = '-';
+  // 从最高位开始，每位取出bits个二进制位，可能跨越两个limb
+  const auto mask = static_cast<limb_t>(base - 1);
+  for (size_type j = digits; j-- > 0;) {
+    const size_type position = j * static_cast<size_type>(bits);
+    const size_type limb = position / limb_bits;
+    wide_t window = N.array_[limb];
+    if (limb + 1 < N.length_)
+      window |= static_cast<wide_t>(N.array_[limb + 1]) << limb_bits;
+    *first++ = digit_chars[(window >> (position % limb_bits)) & mask];
+  }
+  return {first, std::errc{}};
+}
+auto from_chars(const char *first, const char *last, BigInt &N, int base)
+    -> std::from_chars_result {
+  const int bits = radix_bits(base);
+  if (!bits)
+    return from_chars(first, last, N);
+  const bool negative = first != last && *first == '-';
+  const char *begin = negative ? first + 1 : first;
+  const char *end = std::find_if_not(
+      begin, last, [base](char c) { return digit_value(c) < base; });
+  if (begin == end)
+    return {first, std::errc::invalid_argument};
+  // 从最低位开始，每位写入bits个二进制位
+  const auto total_bits =
+      static_cast<size_type>(end - begin) * static_cast<size_type>(bits);
+  const size_type n = (total_bits + limb_bits - 1) / limb_bits;
+  N.length_ = 1;
+  N.reserve(n);
+  std::fill(N.array_, N.array_ + n, 0);
+  size_type position = 0;
+  for (const char *p = end; p-- != begin;
+       position += static_cast<size_type>(bits)) {
+    const auto digit = static_cast<limb_t>(digit_value(*p));
+    const size_type limb = position / limb_bits;
+    const auto offset = static_cast<int>(position % limb_bits);
+    N.array_[limb] |= digit << offset;
+    if (offset + bits > limb_bits)
+      N.array_[limb + 1] |= digit >> (limb_bits - offset);
+  }
+  N.getLength(n);
+  N.negative_ = negative;
+  N.un_negative_zero();
+  return {end, std::errc{}};
+}
+BigInt::BigInt(std::string_view text, int base) : BigInt() {
+  const char *last = text.data() + text.size();
+  const auto [end, ec] = from_chars(text.data(), last, *this, base);
+  if (ec != std::errc{} || end != last)
+    throw std::invalid_argument{"string isn't a number in the given base"};
+}
+auto BigInt::to_string(int base) const -> std::string {
+  const int bits = radix_bits(base);
+  if (!bits)
+    return to_string();
+  std::string result(radix_digits(array_, length_, bits) + 1, '\0');
+  const auto [end, ec] =
+      to_chars(result.data(), result.data() + result.size(), *this, base);
+  result.resize(static_cast<size_type>(end - result.data()));
+  return result;
+}
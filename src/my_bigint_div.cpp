@@ -0,0 +1,312 @@
+// my_bigint_div.cpp
+// 大整数除法：单limb除数直接短除，其余用Knuth算法D，
+// 除数和商都很长时用Burnikel-Ziegler递归除法，除数远长于商时只用高位部分试商
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+using namespace my_bigint_detail;
+namespace {
+// 除数和商的limb数都达到阈值才使用递归除法
+constexpr BigInt::size_type recursive_division_threshold = 80;
+// 除数不超过阈值时倒数直接用除法求
+constexpr BigInt::size_type reciprocal_threshold = 160;
+} // namespace
+
+auto my_bigint_detail::divmod_knuth(limb_t *q, limb_t *r, const limb_t *u,
+                                    size_type un, const limb_t *v,
+                                    size_type vn) -> void {
+  assert(un >= vn && vn >= 2 && v[vn - 1] != 0);
+  // 左移使除数最高位为1，这样试商最多偏大2
+  // 规范化后的被除数多一个limb，整个除法只分配这一次
+  const int s = std::countl_zero(v[vn - 1]);
+  limb_buffer buffer(un + 1 + vn);
+  limb_t *un_ = buffer.get(), *vn_ = un_ + un + 1;
+  if (s) {
+    lshift(vn_, v, vn, s);
+    un_[un] = lshift(un_, u, un, s);
+  } else {
+    std::memcpy(vn_, v, vn * sizeof(limb_t));
+    std::memcpy(un_, u, un * sizeof(limb_t));
+    un_[un] = 0;
+  }
+
+  const wide_t base = wide_t{1} << limb_bits;
+  const limb_t v_top = vn_[vn - 1], v_next = vn_[vn - 2];
+  for (size_type j = un - vn + 1; j-- > 0;) {
+    // 用被除数最高两位除以除数最高位试商，再用次高位修正
+    const wide_t numerator =
+        (static_cast<wide_t>(un_[j + vn]) << limb_bits) | un_[j + vn - 1];
+    wide_t qhat = numerator / v_top, rhat = numerator % v_top;
+    while (qhat >= base ||
+           qhat * v_next > ((rhat << limb_bits) | un_[j + vn - 2])) {
+      --qhat;
+      rhat += v_top;
+      if (rhat >= base)
+        break;
+    }
+    // 原地乘减，不够减说明试商仍大1，加回一次除数
+    const limb_t borrow =
+        submul_1(un_ + j, vn_, vn, static_cast<limb_t>(qhat));
+    const bool negative = un_[j + vn] < borrow;
+    un_[j + vn] -= borrow;
+    if (negative) {
+      --qhat;
+      un_[j + vn] += add_n(un_ + j, un_ + j, vn, vn_, vn);
+    }
+    if (q)
+      q[j] = static_cast<limb_t>(qhat);
+  }
+  if (!r)
+    return;
+  // 余数右移还原
+  if (s)
+    rshift(r, un_, vn, s);
+  else
+    std::memcpy(r, un_, vn * sizeof(limb_t));
+}
+
+auto BigInt::divide_integer_uint(std::uintmax_t N, bool N_is_negative,
+                                 std::size_t type_size) const
+    -> bigInt_division_result {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::divide, length_};
+  if (!N) {
+    throw std::invalid_argument{"can't divide by zero"};
+  }
+  if (Is_zero()) {
+    return bigInt_division_result{};
+  }
+  BigInt quotient(0, this->length_);
+  const std::uintmax_t remainder =
+      divmod_small_limbs(quotient.array_, array_, length_, N);
+  quotient.negative_ = (negative_ != N_is_negative);
+  quotient.getLength(length_);
+
+  return bigInt_division_result{quotient,
+                                BigInt{remainder, type_size, this->negative_}};
+}
+auto BigInt::divmod_small_limbs(value_type *q, const value_type *a,
+                                size_type n, std::uintmax_t N)
+    -> std::uintmax_t {
+  if (N <= std::numeric_limits<value_type>::max())
+    return divmod_1(q, a, n, static_cast<value_type>(N));
+  return divmod_1_wide(q, a, n, N);
+}
+auto BigInt::divmod_small_uint(std::uintmax_t N, bool N_is_negative)
+    -> std::uintmax_t {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::divide, length_};
+  if (!N) {
+    throw std::invalid_argument{"can't divide by zero"};
+  }
+  const std::uintmax_t remainder = divmod_small_limbs(array_, array_, length_, N);
+  negative_ = negative_ != N_is_negative;
+  getLength(length_);
+  return remainder;
+}
+
+auto BigInt::divide(const BigInt &N) const -> bigInt_division_result {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::divide, std::max(length_, N.length_)};
+  if (N.Is_zero()) {
+    throw std::invalid_argument{"can't divide by zero"};
+  }
+  // 被除数绝对值更小的时候商为0，余数为被除数
+  if (this->cmp_abs_less(N))
+    return bigInt_division_result{BigInt{0}, BigInt{*this}};
+  // 不超过64位的除数按limb短除
+  if (N.length_ <= initial_size<std::uintmax_t>)
+    return divide_integer_uint(N.low_word(), N.negative_, N.length_);
+  // 除数和商都足够长时递归除法的乘法才能用上快速算法
+  if (N.length_ >= recursive_division_threshold &&
+      length_ - N.length_ >= recursive_division_threshold) {
+    bigInt_division_result result{divide_large(N)};
+    result.quotient.negative_ = (negative_ != N.negative_);
+    result.quotient.un_negative_zero();
+    result.remainder.negative_ = negative_;
+    result.remainder.un_negative_zero();
+    return result;
+  }
+  return divide_basecase(N);
+}
+auto BigInt::divide_basecase(const BigInt &N) const -> bigInt_division_result {
+  if (this->cmp_abs_less(N))
+    return bigInt_division_result{BigInt{0}, BigInt{*this}};
+  if (N.length_ <= initial_size<std::uintmax_t>)
+    return divide_integer_uint(N.low_word(), N.negative_, N.length_);
+  BigInt quotient(0, length_ - N.length_ + 1), remainder(0, N.length_);
+  divmod_knuth(quotient.array_, remainder.array_, array_, length_, N.array_,
+               N.length_);
+  quotient.negative_ = (negative_ != N.negative_); // 同号为正
+  quotient.getLength(length_ - N.length_ + 1);
+  remainder.negative_ = this->negative_;
+  remainder.getLength(N.length_);
+  return bigInt_division_result{quotient, remainder};
+}
+auto BigInt::divide_in_place(std::uintmax_t N, bool N_is_negative,
+                             bool keep_remainder) -> void {
+  const bool negative = negative_;
+  const std::uintmax_t remainder = divmod_small_uint(N, N_is_negative);
+  if (!keep_remainder)
+    return;
+  // 余数与被除数同号，容量至少为inline_capacity，一定放得下
+  array_[0] = static_cast<value_type>(remainder);
+  array_[1] = static_cast<value_type>(remainder >> limb_bits);
+  negative_ = negative;
+  getLength(2);
+}
+auto BigInt::divide_in_place(const BigInt &N, bool keep_remainder) -> void {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::divide, std::max(length_, N.length_)};
+  if (N.Is_zero()) {
+    throw std::invalid_argument{"can't divide by zero"};
+  }
+  if (this->cmp_abs_less(N)) {
+    if (!keep_remainder) {
+      array_[0] = 0;
+      getLength(1);
+    }
+    return;
+  }
+  if (N.length_ <= initial_size<std::uintmax_t>) {
+    divide_in_place(N.low_word(), N.negative_, keep_remainder);
+    return;
+  }
+  if (N.length_ >= recursive_division_threshold &&
+      length_ - N.length_ >= recursive_division_threshold) {
+    bigInt_division_result result{divide(N)};
+    *this = keep_remainder ? std::move(result.remainder)
+                           : std::move(result.quotient);
+    return;
+  }
+  // Knuth算法D先复制被除数，商或余数可以直接写回array_
+  const size_type un = length_, vn = N.length_;
+  if (keep_remainder) {
+    divmod_knuth(nullptr, array_, array_, un, N.array_, vn);
+    getLength(vn);
+    return;
+  }
+  negative_ = negative_ != N.negative_;
+  divmod_knuth(array_, nullptr, array_, un, N.array_, vn);
+  getLength(un - vn + 1);
+}
+auto BigInt::divide_recursive(const BigInt &A, const BigInt &B, size_type m)
+    -> bigInt_division_result {
+  // Modern Computer Arithmetic 算法1.8 RecursiveDivRem
+  if (m < recursive_division_threshold)
+    return A.divide_basecase(B);
+  // 除数比商长得多时，同时去掉低t个limb，被除数和除数约为2m和m+1个limb，
+  // 试商q = A1/B1不小于真实的商且最多偏大2，再用一次乘法修正
+  if (B.length_ > 2 * m) {
+    const auto t = static_cast<std::intmax_t>(B.length_ - m - 1);
+    BigInt Q{A.limb_shift(-t).divide(B.limb_shift(-t)).quotient};
+    BigInt R{A - Q * B};
+    while (R.negative_) {
+      Q = Q - BigInt{1};
+      R = R + B;
+    }
+    return bigInt_division_result{Q, R};
+  }
+  const auto k = static_cast<std::intmax_t>(m / 2);
+  // B = B1*B^k + B0，B1仍然最高位为1
+  const BigInt B1{B.limb_shift(-k)}, B0{B.low_limbs(static_cast<size_type>(k))};
+
+  // 高半部分：A/B^2k 除以 B1，再用B0修正，试商最多偏大2
+  auto [Q1, R1] = divide_recursive(A.limb_shift(-2 * k), B1,
+                                   m - static_cast<size_type>(k));
+  BigInt A1{R1.limb_shift(2 * k) + A.low_limbs(static_cast<size_type>(2 * k)) -
+            (Q1 * B0).limb_shift(k)};
+  if (A1.negative_) {
+    const BigInt Bk{B.limb_shift(k)};
+    while (A1.negative_) {
+      Q1 = Q1 - BigInt{1};
+      A1 = A1 + Bk;
+    }
+  }
+  // 低半部分同理
+  auto [Q0, R0] =
+      divide_recursive(A1.limb_shift(-k), B1, static_cast<size_type>(k));
+  BigInt A2{R0.limb_shift(k) + A1.low_limbs(static_cast<size_type>(k)) -
+            Q0 * B0};
+  while (A2.negative_) {
+    Q0 = Q0 - BigInt{1};
+    A2 = A2 + B;
+  }
+  return bigInt_division_result{Q1.limb_shift(k) + Q0, A2};
+}
+auto BigInt::divide_large(const BigInt &N) const -> bigInt_division_result {
+  // 同时左移使除数最高位为1，商不变，余数最后右移还原
+  const int s = std::countl_zero(N.array_[N.length_ - 1]);
+  BigInt B{abs(N).abs_shift(s)}, A{abs(*this).abs_shift(s)};
+  const size_type n = B.length_;
+
+  // 被除数从高到低每次取不超过n个limb，与上一次余数拼接后递归相除，
+  // 上一次余数小于B，保证每一块满足递归除法的前提
+  size_type rest = A.length_ - n;
+  BigInt quotient(0, rest + 1);
+  quotient.fillZero();
+  BigInt remainder{from_limbs(A.array_ + rest, n)};
+  if (!remainder.cmp_abs_less(B)) {
+    remainder = remainder - B;
+    quotient[rest] = 1;
+  }
+  while (rest) {
+    const size_type m = std::min(rest, n);
+    rest -= m;
+    BigInt current{remainder.limb_shift(static_cast<std::intmax_t>(m)) +
+                   from_limbs(A.array_ + rest, m)};
+    auto [q, r] = divide_recursive(current, B, m);
+    // q < B^m，直接写入对应位置
+    assert(q.length_ <= m);
+    std::memcpy(quotient.array_ + rest, q.array_, q.length_ * sizeof(value_type));
+    remainder = std::move(r);
+  }
+  quotient.getLength(A.length_ - n + 1);
+  return bigInt_division_result{quotient, remainder.abs_shift(-s)};
+}
+auto BigInt::reciprocal(const BigInt &D) -> BigInt {
+  const size_type n = D.length_;
+  const BigInt power{BigInt{1}.limb_shift(static_cast<std::intmax_t>(2 * n))};
+  if (n <= reciprocal_threshold)
+    return power.divide(D).quotient;
+  // 用D的高h个limb递归求近似倒数，相对误差约B^-(h-1)
+  // 一次牛顿迭代 X += X*(B^2n - D*X)/B^2n 后误差平方，只剩常数级
+  const size_type h = n / 2 + 2;
+  const auto shift = static_cast<std::intmax_t>(n - h);
+  BigInt X{reciprocal(D.limb_shift(-shift)).limb_shift(shift)};
+  const BigInt E{power - D * X};
+  X = X + (X * E).limb_shift(-static_cast<std::intmax_t>(2 * n));
+  // 最后按余数精确修正，余数很小，这一步的除法只有常数个limb的商
+  const BigInt remainder{power - D * X};
+  if (remainder.negative_ || !remainder.cmp_abs_less(D)) {
+    auto [q, r] = remainder.divide(D);
+    // 向下取整
+    if (r.negative_)
+      q = q - BigInt{1};
+    X = X + q;
+  }
+  return X;
+}
+auto BigInt::divide_barrett(const BigInt &x, const BigInt &D, const BigInt &mu)
+    -> bigInt_division_result {
+  const auto n = static_cast<std::intmax_t>(D.length_);
+  // 估计的商最多比真实值小2
+  BigInt q{(x.limb_shift(-(n - 1)) * mu).limb_shift(-(n + 1))};
+  BigInt r{x - q * D};
+  while (r.negative_) {
+    q = q - BigInt{1};
+    r = r + D;
+  }
+  while (!r.cmp_abs_less(D)) {
+    q = q + BigInt{1};
+    r = r - D;
+  }
+  return bigInt_division_result{q, r};
+}
@@ -0,0 +1,321 @@
+// my_bigint_gcd.cpp
+// 最大公约数：64位以内用二进制GCD；较短时用Lehmer算法，由最高62位模拟欧几里得
+// 算法的若干步，得到单limb的系数后一次遍历更新两个数；较长时用half-GCD，
+// 递归地由高半部分求出约简矩阵，把两个数同时缩短一半
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+using namespace my_bigint_detail;
+namespace {
+// 达到阈值后用half-GCD，由my_bigint_bench的gcd测得，以下Lehmer更快
+constexpr size_type hgcd_threshold_limbs = 600;
+// Lehmer内层循环的系数上限，保证更新时的乘积在128位中不溢出
+constexpr std::int64_t lehmer_cofactor_limit = std::int64_t{1} << 31;
+
+__extension__ typedef __int128 int128_t;
+
+// 二进制GCD，反复去掉因子2并大减小
+auto binary_gcd(std::uint64_t a, std::uint64_t b) -> std::uint64_t {
+  if (!a || !b)
+    return a | b;
+  const int shift = std::countr_zero(a | b);
+  a >>= std::countr_zero(a);
+  do {
+    b >>= std::countr_zero(b);
+    if (a > b)
+      std::swap(a, b);
+    b -= a;
+  } while (b);
+  return a << shift;
+}
+
+// (a';b') = [[a,b],[c,d]](a;b)，每一项的绝对值不超过lehmer_cofactor_limit
+struct cofactors {
+  std::int64_t a = 1, b = 0, c = 0, d = 1;
+};
+// Knuth算法L：由u、v的最高62位（相同的移位）模拟欧几里得算法，
+// 两个端点的商相同时这一步对完整的数也成立；第一步就无法确定时b为0
+auto lehmer_cofactors(const limb_t *u, const limb_t *v, size_type n)
+    -> cofactors {
+  const int shift = std::countl_zero(u[n - 1]);
+  const auto top = [n, shift](const limb_t *x) -> std::int64_t {
+    std::uint64_t high = (static_cast<std::uint64_t>(x[n - 1]) << limb_bits) |
+                         x[n - 2];
+    if (shift)
+      high = (high << shift) | (x[n - 3] >> (limb_bits - shift));
+    return static_cast<std::int64_t>(high >> 2);
+  };
+  std::int64_t uh = top(u), vh = top(v);
+  cofactors m;
+  for (;;) {
+    if (vh + m.c <= 0 || vh + m.d <= 0)
+      break;
+    const std::int64_t q = (uh + m.a) / (vh + m.c);
+    if (q != (uh + m.b) / (vh + m.d))
+      break;
+    const int128_t c = m.a - static_cast<int128_t>(q) * m.c;
+    const int128_t d = m.b - static_cast<int128_t>(q) * m.d;
+    if (c >= lehmer_cofactor_limit || c <= -lehmer_cofactor_limit ||
+        d >= lehmer_cofactor_limit || d <= -lehmer_cofactor_limit)
+      break;
+    m = {m.c, m.d, static_cast<std::int64_t>(c), static_cast<std::int64_t>(d)};
+    const std::int64_t t = uh - q * vh;
+    uh = vh;
+    vh = t;
+  }
+  return m;
+}
+// 原地计算(u;v) = m(u;v)，每个limb只依赖同一位置的输入和进位，一次遍历
+// 结果一定非负且不超过原来的u，n个limb放得下
+auto lehmer_update(limb_t *u, limb_t *v, size_type n, const cofactors &m)
+    -> void {
+  int128_t cu = 0, cv = 0;
+  for (size_type i = 0; i < n; i++) {
+    const limb_t x = u[i], y = v[i];
+    cu += static_cast<int128_t>(m.a) * x + static_cast<int128_t>(m.b) * y;
+    cv += static_cast<int128_t>(m.c) * x + static_cast<int128_t>(m.d) * y;
+    u[i] = static_cast<limb_t>(cu);
+    v[i] = static_cast<limb_t>(cv);
+    cu >>= limb_bits;
+    cv >>= limb_bits;
+  }
+  assert(cu == 0 && cv == 0);
+}
+} // namespace
+
+// 所有运算都在非负数上进行，调用方保证a>=b
+class BigInt::gcd_engine {
+public:
+  // 约简矩阵，(原来的a;原来的b) = U(a;b)，各项非负，det为行列式±1
+  // 原地计算(x, y) = (x*r00 + y*r10, x*r01 + y*r11)，各数非负
+  static auto combine(BigInt &x, BigInt &y, limb_t r00, limb_t r01, limb_t r10,
+                      limb_t r11) -> void {
+    // 两个单limb乘积之和最多多出两个limb
+    const size_type n = std::max(x.length_, y.length_) + 2;
+    x.reserve(n);
+    y.reserve(n);
+    std::fill(x.array_ + x.length_, x.array_ + n, 0);
+    std::fill(y.array_ + y.length_, y.array_ + n, 0);
+    uint128_t cx = 0, cy = 0;
+    for (size_type i = 0; i < n; i++) {
+      const wide_t a = x.array_[i], b = y.array_[i];
+      cx += static_cast<uint128_t>(a * r00) + b * r10;
+      cy += static_cast<uint128_t>(a * r01) + b * r11;
+      x.array_[i] = static_cast<limb_t>(cx);
+      y.array_[i] = static_cast<limb_t>(cy);
+      cx >>= limb_bits;
+      cy >>= limb_bits;
+    }
+    x.getLength(n);
+    y.getLength(n);
+  }
+
+  struct matrix {
+    BigInt u00{1}, u01{0}, u10{0}, u11{1};
+    int det = 1;
+
+    [[nodiscard]] auto is_identity() const -> bool {
+      return u01.Is_zero() && u10.Is_zero();
+    }
+    // U = U*R
+    auto multiply(const matrix &r) -> void {
+      BigInt v00{u00 * r.u00 + u01 * r.u10}, v01{u00 * r.u01 + u01 * r.u11};
+      BigInt v10{u10 * r.u00 + u11 * r.u10}, v11{u10 * r.u01 + u11 * r.u11};
+      u00 = std::move(v00);
+      u01 = std::move(v01);
+      u10 = std::move(v10);
+      u11 = std::move(v11);
+      det *= r.det;
+    }
+    // U = U*[[r00,r01],[r10,r11]]，系数都是非负的单limb，每行一次遍历
+    auto multiply(limb_t r00, limb_t r01, limb_t r10, limb_t r11, int r_det)
+        -> void {
+      combine(u00, u01, r00, r01, r10, r11);
+      combine(u10, u11, r00, r01, r10, r11);
+      det *= r_det;
+    }
+    // U = U*[[q,1],[1,0]]，对应一步a,b = b,a-q*b
+    auto quotient_step(const BigInt &q) -> void {
+      BigInt v00{u00 * q + u01}, v10{u10 * q + u11};
+      u01 = std::exchange(u00, std::move(v00));
+      u11 = std::exchange(u10, std::move(v10));
+      det = -det;
+    }
+    // 交换两列，对应交换a和b
+    auto swap_columns() -> void {
+      std::swap(u00, u01);
+      std::swap(u10, u11);
+      det = -det;
+    }
+  };
+
+  // 一步欧几里得除法
+  static auto division_step(BigInt &a, BigInt &b, matrix *U) -> void {
+    if (U) {
+      bigInt_division_result parts{a.divide(b)};
+      U->quotient_step(parts.quotient);
+      a = std::move(parts.remainder);
+    } else {
+      a %= b;
+    }
+    std::swap(a, b);
+  }
+  // Lehmer的一步，约减去一个limb；a不少于3个limb
+  static auto lehmer_step(BigInt &a, BigInt &b, matrix *U) -> void {
+    const size_type n = a.length_;
+    b.reserve(n);
+    std::fill(b.array_ + b.length_, b.array_ + n, 0);
+    const cofactors m = lehmer_cofactors(a.array_, b.array_, n);
+    if (m.b == 0) {
+      division_step(a, b, U);
+      return;
+    }
+    lehmer_update(a.array_, b.array_, n, m);
+    a.getLength(n);
+    b.getLength(n);
+    if (U) {
+      // m的逆为det*[[d,-b],[-c,a]]，各项非负
+      const std::int64_t det = m.a * m.d - m.b * m.c;
+      U->multiply(static_cast<limb_t>(det * m.d),
+                  static_cast<limb_t>(-det * m.b),
+                  static_cast<limb_t>(-det * m.c),
+                  static_cast<limb_t>(det * m.a), static_cast<int>(det));
+    }
+  }
+  // 反复约简直到b不超过stop个limb或为0
+  static auto lehmer_reduce(BigInt &a, BigInt &b, matrix *U, size_type stop)
+      -> void {
+    while (!b.Is_zero() && b.length_ > stop) {
+      if (a.length_ >= 3)
+        lehmer_step(a, b, U);
+      else
+        division_step(a, b, U);
+    }
+  }
+  // 由高p个limb递归求约简矩阵R，再用R的逆约简完整的a、b
+  // (a;b) = (a_hi;b_hi)B^p + (a_lo;b_lo)，高位部分已经约简，只需把R的逆作用于
+  // 低p个limb再加上去；高位部分的商与完整的数不一致时结果会出现负数，这时放弃R
+  static auto reduce_top(BigInt &a, BigInt &b, matrix *U, size_type p)
+      -> void {
+    const auto shift = static_cast<std::intmax_t>(p);
+    BigInt high_a{a.limb_shift(-shift)}, high_b{b.limb_shift(-shift)};
+    matrix R;
+    hgcd(high_a, high_b, &R);
+    if (R.is_identity())
+      return;
+    const BigInt low_a{a.low_limbs(p)}, low_b{b.low_limbs(p)};
+    BigInt x{R.u11 * low_a - R.u01 * low_b}, y{R.u00 * low_b - R.u10 * low_a};
+    // 行列式为-1时逆矩阵整体取反
+    if (R.det < 0) {
+      x.negative_ = !x.negative_;
+      y.negative_ = !y.negative_;
+      x.un_negative_zero();
+      y.un_negative_zero();
+    }
+    x += high_a.limb_shift(shift);
+    y += high_b.limb_shift(shift);
+    if (x.negative_ || y.negative_)
+      return;
+    if (x < y) {
+      std::swap(x, y);
+      R.swap_columns();
+    }
+    a = std::move(x);
+    b = std::move(y);
+    if (U)
+      U->multiply(R);
+  }
+  // half-GCD：把n个limb的a、b约简到b约为n/2个limb，U不为nullptr时记录约简矩阵
+  // 只有递归内部需要矩阵，最外层不记录，省去最大的几次矩阵乘法
+  static auto hgcd(BigInt &a, BigInt &b, matrix *U) -> void {
+    const size_type n = a.length_, s = n / 2 + 1;
+    if (b.length_ <= s)
+      return;
+    if (n < hgcd_threshold_limbs) {
+      lehmer_reduce(a, b, U, s);
+      return;
+    }
+    // 高n-s个limb约简一半后，整体约为3n/4个limb
+    reduce_top(a, b, U, s);
+    if (b.length_ <= s)
+      return;
+    division_step(a, b, U);
+    if (b.length_ <= s)
+      return;
+    // 高2(n2-s)个limb约简一半后，整体约为s个limb
+    const size_type n2 = a.length_;
+    if (2 * s > n2 && n2 - (2 * s - n2) >= 3)
+      reduce_top(a, b, U, 2 * s - n2);
+    lehmer_reduce(a, b, U, s);
+  }
+  // 完整的GCD，a、b约简到b为0，a即为结果；U为nullptr时不记录矩阵
+  static auto reduce(BigInt &a, BigInt &b, matrix *U) -> void {
+    while (!b.Is_zero()) {
+      if (!U && a.length_ <= initial_size<std::uintmax_t>) {
+        a = BigInt{binary_gcd(a.low_word(), b.low_word())};
+        b = BigInt{0};
+        return;
+      }
+      // 长度相差较大时先做一次除法，half-GCD要求两者长度相近
+      if (a.length_ >= hgcd_threshold_limbs &&
+          b.length_ + a.length_ / 4 >= a.length_) {
+        const size_type before = b.length_;
+        hgcd(a, b, U);
+        if (b.length_ < before)
+          continue;
+      }
+      if (a.length_ >= 3)
+        lehmer_step(a, b, U);
+      else
+        division_step(a, b, U);
+    }
+  }
+};
+
+auto BigInt::gcd(const BigInt &a, const BigInt &b) -> BigInt {
+  BigInt x{abs(a)}, y{abs(b)};
+  if (x < y)
+    std::swap(x, y);
+  gcd_engine::reduce(x, y, nullptr);
+  return x;
+}
+auto BigInt::xgcd(const BigInt &a, const BigInt &b) -> xgcd_result {
+  if (b.Is_zero())
+    return {abs(a), BigInt{a.negative_ ? -1 : a.Is_zero() ? 0 : 1}, BigInt{0}};
+  BigInt x{abs(a)}, y{abs(b)};
+  const bool swapped = x < y;
+  if (swapped)
+    std::swap(x, y);
+  gcd_engine::matrix U;
+  gcd_engine::reduce(x, y, &U);
+  // (|a|;|b|) = U(g;0)，g = det*(u11*|a| - u01*|b|)
+  BigInt s{U.det > 0 ? U.u11 : -U.u11};
+  if (swapped)
+    s = U.det > 0 ? -U.u01 : U.u01;
+  if (a.negative_) {
+    s.negative_ = !s.negative_;
+    s.un_negative_zero();
+  }
+  // 归一化到[0, |b|/g)，再由a*s + b*t = g求t
+  const BigInt period{abs(b) / x};
+  s %= period;
+  if (s.negative_)
+    s += period;
+  BigInt t{(x - a * s) / b};
+  return {std::move(x), std::move(s), std::move(t)};
+}
+auto BigInt::modinv(const BigInt &a, const BigInt &m) -> BigInt {
+  if (m.negative_ || m.Is_zero())
+    throw std::invalid_argument{"modulus must be positive"};
+  xgcd_result result{xgcd(a, m)};
+  if (result.gcd != 1)
+    throw std::invalid_argument{"not invertible"};
+  // m为1时x已经是0
+  return std::move(result.x);
+}
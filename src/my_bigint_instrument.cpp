@@ -0,0 +1,207 @@
+// my_bigint_instrument.cpp
+// 运算统计：每个线程一份计数器，只由所属线程写入；查询时在锁内汇总所有线程，
+// 线程退出时把计数并入retired，全局统计不会丢失
+#include "my_bigint_instrument.h"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+#ifdef MY_BIGINT_INSTRUMENT
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif
+
+using namespace my_bigint_detail;
+using size_type = BigInt::size_type;
+
+#ifdef MY_BIGINT_INSTRUMENT
+namespace {
+constexpr size_type buckets = BigInt::statistics::histogram_buckets;
+constexpr auto other = static_cast<int>(BigInt::operation::other);
+
+// 其他线程只读，所属线程用relaxed的读加写代替原子加法，没有锁前缀的开销
+struct atomic_counters {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> nanoseconds{0};
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> allocated_bytes{0};
+  std::atomic<std::uint64_t> copies{0};
+  std::atomic<std::uint64_t> limb_histogram[buckets] = {};
+};
+auto bump(std::atomic<std::uint64_t> &counter, std::uint64_t n) noexcept
+    -> void {
+  counter.store(counter.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+auto load(const atomic_counters &from,
+          BigInt::statistics::counters &to) noexcept -> void {
+  to.calls += from.calls.load(std::memory_order_relaxed);
+  to.nanoseconds += from.nanoseconds.load(std::memory_order_relaxed);
+  to.allocations += from.allocations.load(std::memory_order_relaxed);
+  to.allocated_bytes += from.allocated_bytes.load(std::memory_order_relaxed);
+  to.copies += from.copies.load(std::memory_order_relaxed);
+  for (size_type k = 0; k < buckets; k++)
+    to.limb_histogram[k] +=
+        from.limb_histogram[k].load(std::memory_order_relaxed);
+}
+auto clear(atomic_counters &counters) noexcept -> void {
+  for (std::atomic<std::uint64_t> *counter :
+       {&counters.calls, &counters.nanoseconds, &counters.allocations,
+        &counters.allocated_bytes, &counters.copies})
+    counter->store(0, std::memory_order_relaxed);
+  for (std::atomic<std::uint64_t> &counter : counters.limb_histogram)
+    counter.store(0, std::memory_order_relaxed);
+}
+
+struct thread_counters;
+// 所有存活线程的计数器和已退出线程的累计值
+// 故意不析构，其他线程的thread_local可能在静态析构之后才销毁
+struct registry {
+  std::mutex mutex;
+  std::vector<thread_counters *> threads;
+  BigInt::statistics retired;
+};
+auto get_registry() -> registry & {
+  static registry *instance = new registry;
+  return *instance;
+}
+
+struct thread_counters {
+  atomic_counters operations[BigInt::operation_count];
+  int active = -1;
+
+  auto snapshot(BigInt::statistics &stats) const noexcept -> void {
+    for (size_type i = 0; i < BigInt::operation_count; i++)
+      load(operations[i], stats.operations[i]);
+  }
+  thread_counters() {
+    registry &r = get_registry();
+    const std::lock_guard lock{r.mutex};
+    r.threads.push_back(this);
+  }
+  ~thread_counters() {
+    registry &r = get_registry();
+    const std::lock_guard lock{r.mutex};
+    snapshot(r.retired);
+    std::erase(r.threads, this);
+  }
+  thread_counters(const thread_counters &) = delete;
+  auto operator=(const thread_counters &) -> thread_counters & = delete;
+};
+auto local_counters() -> thread_counters & {
+  thread_local thread_counters counters;
+  return counters;
+}
+auto current_counters() -> atomic_counters & {
+  thread_counters &local = local_counters();
+  return local.operations[local.active < 0 ? other : local.active];
+}
+} // namespace
+
+auto my_bigint_detail::active_operation() noexcept -> int {
+  return local_counters().active;
+}
+auto my_bigint_detail::record_allocation(std::size_t bytes) noexcept -> void {
+  atomic_counters &counters = current_counters();
+  bump(counters.allocations, 1);
+  bump(counters.allocated_bytes, bytes);
+}
+auto my_bigint_detail::record_copy() noexcept -> void {
+  bump(current_counters().copies, 1);
+}
+
+instrument_scope::instrument_scope(BigInt::operation operation,
+                                   std::size_t limbs) noexcept
+    : outermost_{local_counters().active < 0}, operation_{operation} {
+  if (!outermost_)
+    return;
+  local_counters().active = static_cast<int>(operation);
+  atomic_counters &counters =
+      local_counters().operations[static_cast<size_type>(operation)];
+  bump(counters.calls, 1);
+  const auto bucket = std::min<size_type>(
+      static_cast<size_type>(std::bit_width(std::max<std::size_t>(limbs, 1))) -
+          1,
+      buckets - 1);
+  bump(counters.limb_histogram[bucket], 1);
+  start_ = clock::now();
+}
+instrument_scope::~instrument_scope() {
+  if (!outermost_)
+    return;
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      clock::now() - start_);
+  bump(local_counters()
+           .operations[static_cast<size_type>(operation_)]
+           .nanoseconds,
+       static_cast<std::uint64_t>(elapsed.count()));
+  local_counters().active = -1;
+}
+
+operation_override::operation_override(int operation) noexcept
+    : previous_{std::exchange(local_counters().active, operation)} {}
+operation_override::~operation_override() {
+  local_counters().active = previous_;
+}
+
+auto BigInt::thread_statistics() -> statistics {
+  statistics stats;
+  local_counters().snapshot(stats);
+  return stats;
+}
+auto BigInt::global_statistics() -> statistics {
+  registry &r = get_registry();
+  const std::lock_guard lock{r.mutex};
+  statistics stats{r.retired};
+  for (const thread_counters *counters : r.threads)
+    counters->snapshot(stats);
+  return stats;
+}
+auto BigInt::reset_statistics() noexcept -> void {
+  registry &r = get_registry();
+  const std::lock_guard lock{r.mutex};
+  r.retired = statistics{};
+  for (thread_counters *counters : r.threads)
+    for (atomic_counters &operation : counters->operations)
+      clear(operation);
+}
+#else
+auto BigInt::thread_statistics() -> statistics { return {}; }
+auto BigInt::global_statistics() -> statistics { return {}; }
+auto BigInt::reset_statistics() noexcept -> void {}
+#endif
+
+auto BigInt::statistics::operator+=(const statistics &other) noexcept
+    -> statistics & {
+  for (size_type i = 0; i < operation_count; i++) {
+    counters &to = operations[i];
+    const counters &from = other.operations[i];
+    to.calls += from.calls;
+    to.nanoseconds += from.nanoseconds;
+    to.allocations += from.allocations;
+    to.allocated_bytes += from.allocated_bytes;
+    to.copies += from.copies;
+    for (size_type k = 0; k < histogram_buckets; k++)
+      to.limb_histogram[k] += from.limb_histogram[k];
+  }
+  return *this;
+}
+
+auto operator<<(std::ostream &out, const BigInt::statistics &stats)
+    -> std::ostream & {
+  static constexpr const char *names[BigInt::operation_count] = {
+      "construct", "add", "multiply", "divide", "other"};
+  for (size_type i = 0; i < BigInt::operation_count; i++) {
+    const BigInt::statistics::counters &c = stats.operations[i];
+    out << names[i] << ": calls=" << c.calls << " ns=" << c.nanoseconds
+        << " allocations=" << c.allocations << " bytes=" << c.allocated_bytes
+        << " copies=" << c.copies << '\n';
+    for (size_type k = 0; k < BigInt::statistics::histogram_buckets; k++)
+      if (c.limb_histogram[k])
+        out << "  limbs [" << (std::uint64_t{1} << k) << ", "
+            << (std::uint64_t{1} << (k + 1)) << "): " << c.limb_histogram[k]
+            << '\n';
+  }
+  return out;
+}
@@ -0,0 +1,57 @@
+// my_bigint_instrument.h
+// 内部使用的统计钩子，只在src内包含，实现见my_bigint_instrument.cpp
+// 未定义MY_BIGINT_INSTRUMENT时全部为空操作，编译后不留任何代码
+#ifndef MY_BIGINT_INSTRUMENT_H
+#define MY_BIGINT_INSTRUMENT_H
+#include "my_bigint.h"
+#include <chrono>
+#include <cstddef>
+
+namespace my_bigint_detail {
+#ifdef MY_BIGINT_INSTRUMENT
+// 当前线程正在记录的运算，没有时为-1
+[[nodiscard]] auto active_operation() noexcept -> int;
+// 分配和复制计入当前运算，不在任何运算内时计入other
+auto record_allocation(std::size_t bytes) noexcept -> void;
+auto record_copy() noexcept -> void;
+
+// 记录一次运算的调用次数、操作数大小和耗时
+// 只有线程上最外层的作用域记录，运算内部调用的其他运算不重复计数
+class instrument_scope {
+  using clock = std::chrono::steady_clock;
+  bool outermost_;
+  BigInt::operation operation_;
+  clock::time_point start_;
+
+public:
+  instrument_scope(BigInt::operation operation, std::size_t limbs) noexcept;
+  ~instrument_scope();
+  instrument_scope(const instrument_scope &) = delete;
+  auto operator=(const instrument_scope &) -> instrument_scope & = delete;
+};
+// 线程池任务继承发起方的运算，分配计入同一运算但不增加调用次数
+class operation_override {
+  int previous_;
+
+public:
+  explicit operation_override(int operation) noexcept;
+  ~operation_override();
+  operation_override(const operation_override &) = delete;
+  auto operator=(const operation_override &) -> operation_override & = delete;
+};
+#else
+constexpr auto active_operation() noexcept -> int { return -1; }
+constexpr auto record_allocation(std::size_t) noexcept -> void {}
+constexpr auto record_copy() noexcept -> void {}
+class instrument_scope {
+public:
+  constexpr instrument_scope(BigInt::operation, std::size_t) noexcept {}
+};
+class operation_override {
+public:
+  constexpr explicit operation_override(int) noexcept {}
+};
+#endif
+} // namespace my_bigint_detail
+
+#endif // MY_BIGINT_INSTRUMENT_H
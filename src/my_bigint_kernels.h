@@ -0,0 +1,279 @@
+// my_bigint_kernels.h
+// 内部使用的limb级基础运算，只在src内包含
+#ifndef MY_BIGINT_KERNELS_H
+#define MY_BIGINT_KERNELS_H
+#include "my_bigint.h"
+#include "my_bigint_instrument.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace my_bigint_detail {
+using limb_t = BigInt::value_type;
+using wide_t = BigInt::wide_type;
+using size_type = BigInt::size_type;
+constexpr int limb_bits = BigInt::limb_bits;
+// 128位中间结果，GCC和Clang的扩展
+__extension__ typedef unsigned __int128 uint128_t;
+
+// 等长部分的加减和比较，按CPU支持的指令集在运行时选择，实现见my_bigint_simd.cpp
+// add、sub返回最高位的进位或借位，r可以与a重合
+struct simd_kernels {
+  auto (*add)(limb_t *r, const limb_t *a, const limb_t *b, size_type n)
+      -> limb_t;
+  auto (*sub)(limb_t *r, const limb_t *a, const limb_t *b, size_type n)
+      -> limb_t;
+  auto (*cmp)(const limb_t *a, const limb_t *b, size_type n) -> int;
+};
+// 静态初始化前为标量实现，初始化时按CPUID替换
+extern std::atomic<const simd_kernels *> active_simd_kernels;
+// 短于阈值时函数指针调用和向量装载不划算，直接标量计算
+constexpr size_type simd_threshold_limbs = 16;
+inline auto simd() noexcept -> const simd_kernels & {
+  return *active_simd_kernels.load(std::memory_order_relaxed);
+}
+
+// 标量实现，也用于处理向量化之后不足一组的尾部
+inline auto add_n_scalar(limb_t *r, const limb_t *a, const limb_t *b,
+                         size_type n, limb_t carry = 0) -> limb_t {
+  wide_t temp = carry;
+  for (size_type i = 0; i < n; i++) {
+    temp += static_cast<wide_t>(a[i]) + b[i];
+    r[i] = static_cast<limb_t>(temp);
+    temp >>= limb_bits;
+  }
+  return static_cast<limb_t>(temp);
+}
+inline auto sub_n_scalar(limb_t *r, const limb_t *a, const limb_t *b,
+                         size_type n, limb_t borrow = 0) -> limb_t {
+  for (size_type i = 0; i < n; i++) {
+    const wide_t temp = static_cast<wide_t>(a[i]) - b[i] - borrow;
+    r[i] = static_cast<limb_t>(temp);
+    borrow = static_cast<limb_t>(temp >> (2 * limb_bits - 1));
+  }
+  return borrow;
+}
+// 从最高位开始比较
+inline auto cmp_n_scalar(const limb_t *a, const limb_t *b, size_type n)
+    -> int {
+  for (size_type i = n; i-- > 0;)
+    if (a[i] != b[i])
+      return a[i] < b[i] ? -1 : 1;
+  return 0;
+}
+
+// r[0,an) = a[0,an) + b[0,bn)，要求an>=bn，返回最高位进位,r可以与a重合
+inline auto add_n(limb_t *r, const limb_t *a, size_type an, const limb_t *b,
+                  size_type bn) -> limb_t {
+  wide_t carry = bn >= simd_threshold_limbs ? simd().add(r, a, b, bn)
+                                            : add_n_scalar(r, a, b, bn);
+  for (size_type i = bn; i < an; i++) {
+    carry += a[i];
+    r[i] = static_cast<limb_t>(carry);
+    carry >>= limb_bits;
+  }
+  return static_cast<limb_t>(carry);
+}
+// r[0,an) = a[0,an) - b[0,bn)，要求an>=bn，返回最高位借位,r可以与a重合
+inline auto sub_n(limb_t *r, const limb_t *a, size_type an, const limb_t *b,
+                  size_type bn) -> limb_t {
+  limb_t borrow = bn >= simd_threshold_limbs ? simd().sub(r, a, b, bn)
+                                             : sub_n_scalar(r, a, b, bn);
+  for (size_type i = bn; i < an; i++) {
+    const wide_t temp = static_cast<wide_t>(a[i]) - borrow;
+    r[i] = static_cast<limb_t>(temp);
+    borrow = static_cast<limb_t>(temp >> (2 * limb_bits - 1));
+  }
+  return borrow;
+}
+// r[0,n) += carry，返回溢出的进位
+inline auto add_1(limb_t *r, size_type n, limb_t carry) -> limb_t {
+  for (size_type i = 0; carry && i < n; i++) {
+    r[i] += carry;
+    carry = r[i] < carry ? 1 : 0;
+  }
+  return carry;
+}
+// 等长比较，返回-1、0、1
+inline auto cmp_n(const limb_t *a, const limb_t *b, size_type n) -> int {
+  return n >= simd_threshold_limbs ? simd().cmp(a, b, n)
+                                   : cmp_n_scalar(a, b, n);
+}
+// r[0,n) = a[0,n) * m + carry，返回最高位进位,r可以与a重合
+inline auto mul_1(limb_t *r, const limb_t *a, size_type n, limb_t m,
+                  limb_t carry = 0) -> limb_t {
+  wide_t temp = carry;
+  for (size_type i = 0; i < n; i++) {
+    temp += static_cast<wide_t>(a[i]) * m;
+    r[i] = static_cast<limb_t>(temp);
+    temp >>= limb_bits;
+  }
+  return static_cast<limb_t>(temp);
+}
+// r[0,n) = a[0,n) * m，m为64位，返回最高64位进位,r可以与a重合
+// (2^32-1)*(2^64-1)+(2^64-1) < 2^96，128位中间结果不会溢出
+inline auto mul_1_wide(limb_t *r, const limb_t *a, size_type n, wide_t m)
+    -> wide_t {
+  uint128_t temp = 0;
+  for (size_type i = 0; i < n; i++) {
+    temp += static_cast<uint128_t>(a[i]) * m;
+    r[i] = static_cast<limb_t>(temp);
+    temp >>= limb_bits;
+  }
+  return static_cast<wide_t>(temp);
+}
+// r[0,n) += a[0,n) * m，返回需要加到r[n]的进位
+inline auto addmul_1(limb_t *r, const limb_t *a, size_type n, limb_t m)
+    -> limb_t {
+  wide_t temp = 0;
+  for (size_type i = 0; i < n; i++) {
+    temp += static_cast<wide_t>(a[i]) * m + r[i];
+    r[i] = static_cast<limb_t>(temp);
+    temp >>= limb_bits;
+  }
+  return static_cast<limb_t>(temp);
+}
+// r[0,n) -= a[0,n) * m，返回需要从r[n]借走的值
+inline auto submul_1(limb_t *r, const limb_t *a, size_type n, limb_t m)
+    -> limb_t {
+  wide_t carry = 0;
+  for (size_type i = 0; i < n; i++) {
+    carry += static_cast<wide_t>(a[i]) * m;
+    const limb_t low = static_cast<limb_t>(carry);
+    carry >>= limb_bits;
+    carry += r[i] < low ? 1 : 0;
+    r[i] -= low;
+  }
+  return static_cast<limb_t>(carry);
+}
+// r[0,n) = a[0,n) << s，0<s<limb_bits，返回移出的高位，r可以与a重合
+inline auto lshift(limb_t *r, const limb_t *a, size_type n, int s) -> limb_t {
+  const limb_t out = a[n - 1] >> (limb_bits - s);
+  for (size_type i = n - 1; i > 0; i--)
+    r[i] = (a[i] << s) | (a[i - 1] >> (limb_bits - s));
+  r[0] = a[0] << s;
+  return out;
+}
+// r[0,n) = a[0,n) >> s，0<s<limb_bits，r可以与a重合
+inline auto rshift(limb_t *r, const limb_t *a, size_type n, int s) -> void {
+  for (size_type i = 0; i + 1 < n; i++)
+    r[i] = (a[i] >> s) | (a[i + 1] << (limb_bits - s));
+  r[n - 1] = a[n - 1] >> s;
+}
+// q[0,n) = a[0,n) / d，返回余数,q可以与a重合
+inline auto divmod_1(limb_t *q, const limb_t *a, size_type n, limb_t d)
+    -> limb_t {
+  wide_t remainder = 0;
+  for (size_type i = n; i-- > 0;) {
+    remainder = (remainder << limb_bits) | a[i];
+    q[i] = static_cast<limb_t>(remainder / d);
+    remainder %= d;
+  }
+  return static_cast<limb_t>(remainder);
+}
+// q[0,n) = a[0,n) / d，d为64位，返回余数,q可以与a重合
+// 余数小于d，左移一个limb后仍在128位以内，每步的商不超过一个limb
+inline auto divmod_1_wide(limb_t *q, const limb_t *a, size_type n, wide_t d)
+    -> wide_t {
+  uint128_t remainder = 0;
+  for (size_type i = n; i-- > 0;) {
+    remainder = (remainder << limb_bits) | a[i];
+    q[i] = static_cast<limb_t>(remainder / d);
+    remainder %= d;
+  }
+  return static_cast<wide_t>(remainder);
+}
+// 结果长度为an+bn，r不能与a、b重合
+inline auto mul_basecase(limb_t *r, const limb_t *a, size_type an,
+                         const limb_t *b, size_type bn) -> void {
+  // 第一行直接写入，省去清零
+  r[an] = mul_1(r, a, an, b[0]);
+  for (size_type i = 1; i < bn; i++) {
+    // (2^32-1)^2+2*(2^32-1)=2^64-1，64位中间结果不会溢出
+    wide_t temp = 0;
+    for (size_type j = 0; j < an; j++) {
+      temp += static_cast<wide_t>(a[j]) * b[i] + r[i + j];
+      r[i + j] = static_cast<limb_t>(temp);
+      temp >>= limb_bits;
+    }
+    r[i + an] = static_cast<limb_t>(temp);
+  }
+}
+// r[0,2n) = a[0,n)^2，r不能与a重合
+// 交叉项a[i]*a[j](i<j)只算一次再乘2，加上对角项，部分积约为乘法的一半
+inline auto sqr_basecase(limb_t *r, const limb_t *a, size_type n) -> void {
+  if (n == 1) {
+    const wide_t square = static_cast<wide_t>(a[0]) * a[0];
+    r[0] = static_cast<limb_t>(square);
+    r[1] = static_cast<limb_t>(square >> limb_bits);
+    return;
+  }
+  // 第i行写入r[2i+1, i+n]，最高位是新位置，不需要预先清零
+  r[0] = 0;
+  r[n] = mul_1(r + 1, a + 1, n - 1, a[0]);
+  for (size_type i = 1; i + 1 < n; i++) {
+    wide_t temp = 0;
+    for (size_type j = i + 1; j < n; j++) {
+      temp += static_cast<wide_t>(a[j]) * a[i] + r[i + j];
+      r[i + j] = static_cast<limb_t>(temp);
+      temp >>= limb_bits;
+    }
+    r[i + n] = static_cast<limb_t>(temp);
+  }
+  r[2 * n - 1] = 0;
+  lshift(r, r, 2 * n, 1);
+  wide_t carry = 0;
+  for (size_type i = 0; i < n; i++) {
+    const wide_t square = static_cast<wide_t>(a[i]) * a[i];
+    carry += static_cast<wide_t>(r[2 * i]) + static_cast<limb_t>(square);
+    r[2 * i] = static_cast<limb_t>(carry);
+    carry >>= limb_bits;
+    carry += static_cast<wide_t>(r[2 * i + 1]) + (square >> limb_bits);
+    r[2 * i + 1] = static_cast<limb_t>(carry);
+    carry >>= limb_bits;
+  }
+}
+// 去掉最高位的0后的长度，至少为1
+inline auto normalized_length(const limb_t *a, size_type n) -> size_type {
+  while (n > 1 && a[n - 1] == 0)
+    --n;
+  return n;
+}
+
+// 三模数NTT乘法，实现见my_bigint_ntt.cpp
+// r[0,an+bn) = a*b，r不能与a、b重合，要求an+bn不超过ntt_max_limbs
+// a与b相同时只做一次正变换
+constexpr size_type ntt_max_limbs = size_type{1} << 23;
+auto mul_ntt(limb_t *r, const limb_t *a, size_type an, const limb_t *b,
+             size_type bn) -> void;
+
+// Knuth算法D，实现见my_bigint_div.cpp
+// 要求un>=vn>=2且v[vn-1]!=0，商写入q[0,un-vn+1)，余数写入r[0,vn)
+// 被除数和除数先复制，q、r可以与u、v重合；不需要的结果传nullptr
+auto divmod_knuth(limb_t *q, limb_t *r, const limb_t *u, size_type un,
+                  const limb_t *v, size_type vn) -> void;
+
+// 算法内部的临时缓冲区，从当前线程的默认资源分配，离开作用域释放
+class limb_buffer {
+  std::pmr::memory_resource *resource_;
+  size_type size_;
+  limb_t *data_;
+
+public:
+  explicit limb_buffer(size_type n)
+      : resource_{BigInt::default_resource()}, size_{n ? n : 1},
+        data_{static_cast<limb_t *>(
+            resource_->allocate(size_ * sizeof(limb_t), alignof(limb_t)))} {
+    record_allocation(size_ * sizeof(limb_t));
+  }
+  ~limb_buffer() {
+    resource_->deallocate(data_, size_ * sizeof(limb_t), alignof(limb_t));
+  }
+  limb_buffer(const limb_buffer &) = delete;
+  auto operator=(const limb_buffer &) -> limb_buffer & = delete;
+  [[nodiscard]] auto get() const noexcept -> limb_t * { return data_; }
+};
+} // namespace my_bigint_detail
+
+#endif // MY_BIGINT_KERNELS_H
@@ -0,0 +1,186 @@
+// my_bigint_mod.cpp
+// 固定模数的模乘和模幂：较短的奇数模数用Montgomery约简，其余用Barrett约简
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace my_bigint_detail;
+namespace {
+// Montgomery约简逐limb消去，O(n^2)；Barrett约简是两次乘法，
+// 模数超过约1200位十进制数后Barrett更快
+constexpr size_type montgomery_threshold_limbs = 128;
+
+// 滑动窗口宽度，指数越长，预计算2^(k-1)个奇数次幂越划算
+constexpr auto window_bits(size_type exponent_bits) -> size_type {
+  if (exponent_bits <= 8)
+    return 1;
+  if (exponent_bits <= 24)
+    return 2;
+  if (exponent_bits <= 80)
+    return 3;
+  if (exponent_bits <= 240)
+    return 4;
+  if (exponent_bits <= 672)
+    return 5;
+  if (exponent_bits <= 1792)
+    return 6;
+  return 7;
+}
+auto exponent_bit(const BigInt::value_type *e, size_type i) -> bool {
+  return (e[i / limb_bits] >> (i % limb_bits)) & 1U;
+}
+// -a^-1 mod B，a为奇数
+// a*a ≡ 1 (mod 8)，牛顿迭代x = x*(2-a*x)每次正确的位数翻倍
+constexpr auto negated_inverse(limb_t a) -> limb_t {
+  limb_t x = a;
+  for (int i = 0; i < 4; i++)
+    x *= 2 - a * x;
+  return static_cast<limb_t>(0U - x);
+}
+} // namespace
+
+BigInt::modular_context::modular_context(const BigInt &modulus)
+    : modulus_{modulus} {
+  if (modulus_.negative_ || modulus_.Is_zero())
+    throw std::invalid_argument{"modulus must be positive"};
+  const size_type n = modulus_.length_;
+  if ((modulus_[0] & 1U) && n <= montgomery_threshold_limbs) {
+    inverse_ = negated_inverse(modulus_[0]);
+    r2_ = BigInt{1}.limb_shift(static_cast<std::intmax_t>(2 * n)) % modulus_;
+  } else {
+    reciprocal_ = reciprocal(modulus_);
+  }
+}
+
+auto BigInt::modular_context::reduce(const BigInt &x) const -> BigInt {
+  if (!x.negative_ && x.cmp_abs_less(modulus_))
+    return x;
+  BigInt result{x % modulus_};
+  if (result.negative_)
+    result += modulus_;
+  return result;
+}
+
+auto BigInt::modular_context::mul_reduce(BigInt &x, const BigInt &y,
+                                         value_type *scratch) const -> void {
+  if (!is_montgomery()) {
+    // 两个余数的积小于B^(2n)，满足Barrett除法的要求
+    x = divide_barrett(&x == &y ? x.square() : x * y, modulus_, reciprocal_)
+            .remainder;
+    return;
+  }
+  const size_type n = modulus_.length_;
+  const value_type *m = modulus_.array_;
+  // t = x*y，不超过2n个limb，最高位留给约简的进位
+  value_type *t = scratch;
+  if (&x == &y)
+    sqr_limbs(t, x.array_, x.length_);
+  else if (x.length_ >= y.length_)
+    mul_limbs(t, x.array_, x.length_, y.array_, y.length_);
+  else
+    mul_limbs(t, y.array_, y.length_, x.array_, x.length_);
+  std::fill(t + x.length_ + y.length_, t + 2 * n + 1, 0);
+  // 每轮加上q*m使最低位变为0，n轮后t是R的倍数，t/R < 2*modulus
+  for (size_type i = 0; i < n; i++) {
+    const value_type q = t[i] * inverse_;
+    add_1(t + i + n, n + 1 - i, addmul_1(t + i, m, n, q));
+  }
+  value_type *r = t + n;
+  if (r[n] || cmp_n(r, m, n) >= 0)
+    sub_n(r, r, n + 1, m, n);
+  x.reserve(n);
+  std::memcpy(x.array_, r, n * sizeof(value_type));
+  x.getLength(n);
+}
+
+auto BigInt::modular_context::to_domain(const BigInt &x,
+                                        value_type *scratch) const -> BigInt {
+  BigInt result{reduce(x)};
+  // x*R^2/R = x*R
+  if (is_montgomery())
+    mul_reduce(result, r2_, scratch);
+  return result;
+}
+
+auto BigInt::modular_context::from_domain(BigInt &x, value_type *scratch) const
+    -> void {
+  if (is_montgomery())
+    mul_reduce(x, BigInt{1}, scratch);
+}
+
+auto BigInt::modular_context::mul(const BigInt &a, const BigInt &b) const
+    -> BigInt {
+  limb_buffer scratch(2 * modulus_.length_ + 1);
+  // 只把一个因子转入Montgomery域，a*R * b / R = a*b
+  BigInt result{to_domain(a, scratch.get())};
+  mul_reduce(result, reduce(b), scratch.get());
+  return result;
+}
+
+auto BigInt::modular_context::pow(const BigInt &base,
+                                  const BigInt &exponent) const -> BigInt {
+  if (exponent.negative_)
+    throw std::invalid_argument{"exponent must be non-negative"};
+  if (modulus_ == 1)
+    return BigInt{};
+  if (exponent.Is_zero())
+    return BigInt{1};
+  limb_buffer scratch(2 * modulus_.length_ + 1);
+  const value_type *e = exponent.array_;
+  const size_type bits =
+      exponent.length_ * limb_bits -
+      static_cast<size_type>(std::countl_zero(e[exponent.length_ - 1]));
+  const size_type k = window_bits(bits);
+
+  // odd[i] = base^(2i+1)
+  std::vector<BigInt> odd(size_type{1} << (k - 1));
+  odd[0] = to_domain(base, scratch.get());
+  if (k > 1) {
+    BigInt square{odd[0]};
+    mul_reduce(square, square, scratch.get());
+    for (size_type i = 1; i < odd.size(); i++) {
+      odd[i] = odd[i - 1];
+      mul_reduce(odd[i], square, scratch.get());
+    }
+  }
+
+  // 从高位开始，每个窗口以1开头和结尾，窗口之间的0逐位平方
+  BigInt result;
+  bool started = false;
+  size_type i = bits;
+  while (i > 0) {
+    if (!exponent_bit(e, i - 1)) {
+      mul_reduce(result, result, scratch.get());
+      --i;
+      continue;
+    }
+    size_type low = i > k ? i - k : 0;
+    while (!exponent_bit(e, low))
+      ++low;
+    size_type window = 0;
+    for (size_type j = i; j-- > low;)
+      window = window << 1 | static_cast<size_type>(exponent_bit(e, j));
+    if (started) {
+      for (size_type j = low; j < i; j++)
+        mul_reduce(result, result, scratch.get());
+      mul_reduce(result, odd[window >> 1], scratch.get());
+    } else {
+      // 最高位一定是1，第一个窗口直接取预计算的值
+      result = odd[window >> 1];
+      started = true;
+    }
+    i = low;
+  }
+  from_domain(result, scratch.get());
+  return result;
+}
+
+auto BigInt::powmod(const BigInt &base, const BigInt &exponent,
+                    const BigInt &modulus) -> BigInt {
+  return modular_context{modulus}.pow(base, exponent);
+}
@@ -0,0 +1,298 @@
+// my_bigint_mul.cpp
+// 乘法分级：basecase -> Karatsuba -> Toom-3 -> NTT，长度悬殊时分块
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include "my_bigint_parallel.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace my_bigint_detail;
+namespace {
+// 较短乘数的limb数达到阈值后才使用对应算法，阈值以下子乘法开销大于收益
+constexpr size_type karatsuba_threshold = 32;
+// 平方的basecase只有一半部分积，Karatsuba的收益来得更晚
+constexpr size_type sqr_karatsuba_threshold = 48;
+constexpr size_type toom3_threshold = 300;
+constexpr size_type ntt_threshold = 10000;
+
+// 比较a[0,an)与b[0,bn)，要求an>=bn
+auto cmp_abs(const limb_t *a, size_type an, const limb_t *b, size_type bn)
+    -> int {
+  for (size_type i = an; i-- > bn;)
+    if (a[i])
+      return 1;
+  return cmp_n(a, b, bn);
+}
+// r[0,an) = |a[0,an) - b[0,bn)|，要求an>=bn，返回a<b
+auto abs_diff(limb_t *r, const limb_t *a, size_type an, const limb_t *b,
+              size_type bn) -> bool {
+  if (cmp_abs(a, an, b, bn) >= 0) {
+    sub_n(r, a, an, b, bn);
+    return false;
+  }
+  // a<b时a高于bn的部分全为0
+  sub_n(r, b, bn, a, bn);
+  std::fill(r + bn, r + an, 0);
+  return true;
+}
+} // namespace
+
+auto BigInt::from_limbs(const value_type *a, size_type n) -> BigInt {
+  if (!n)
+    return BigInt{0};
+  BigInt result(0, n);
+  std::memcpy(result.array_, a, n * sizeof(value_type));
+  result.getLength(n);
+  return result;
+}
+
+auto BigInt::mul_limbs(value_type *r, const value_type *a, size_type an,
+                       const value_type *b, size_type bn) -> void {
+  assert(an >= bn && bn >= 1);
+  if (a == b && an == bn) {
+    sqr_limbs(r, a, an);
+    return;
+  }
+  if (bn < karatsuba_threshold) {
+    mul_basecase(r, a, an, b, bn);
+    return;
+  }
+  // 足够长时直接做NTT，NTT本身不要求两乘数长度接近
+  if (bn >= ntt_threshold && an + bn <= ntt_max_limbs) {
+    mul_ntt(r, a, an, b, bn);
+    return;
+  }
+  // 较长乘数超过约两倍时对半分会让b的高半部分为空，先分块
+  if (2 * bn <= an + 1) {
+    mul_unbalanced(r, a, an, b, bn);
+    return;
+  }
+  // Toom-3要求b也能分出非空的第三段
+  if (bn >= toom3_threshold && bn > 2 * ((an + 2) / 3)) {
+    mul_toom3(r, a, an, b, bn);
+    return;
+  }
+  mul_karatsuba(r, a, an, b, bn);
+}
+
+auto BigInt::sqr_limbs(value_type *r, const value_type *a, size_type n)
+    -> void {
+  if (n < sqr_karatsuba_threshold) {
+    sqr_basecase(r, a, n);
+    return;
+  }
+  if (n >= ntt_threshold && 2 * n <= ntt_max_limbs) {
+    mul_ntt(r, a, n, a, n);
+    return;
+  }
+  if (n >= toom3_threshold) {
+    mul_toom3(r, a, n, a, n);
+    return;
+  }
+  sqr_karatsuba(r, a, n);
+}
+
+auto BigInt::square() const -> BigInt {
+  [[maybe_unused]] const instrument_scope instrument{
+      operation::multiply, length_};
+  if (Is_zero())
+    return BigInt{0};
+  BigInt result{0, 2 * length_};
+  sqr_limbs(result.array_, array_, length_);
+  result.getLength(2 * length_);
+  return result;
+}
+
+auto BigInt::mul_unbalanced(value_type *r, const value_type *a, size_type an,
+                            const value_type *b, size_type bn) -> void {
+  std::fill(r, r + an + bn, 0);
+  const size_type chunks = (an + bn - 1) / bn;
+  if (parallel_enabled(bn) && chunks > 2) {
+    // 偶数块和奇数块的乘积各自互不重叠，分别直接写入r和odd，最后相加一次
+    limb_buffer odd(an + bn);
+    std::fill(odd.get(), odd.get() + an + bn, 0);
+    parallel_for(0, chunks, 1, [=, &odd](size_type lo, size_type hi) {
+      for (size_type c = lo; c < hi; c++) {
+        const size_type i = c * bn, chunk = std::min(bn, an - i);
+        limb_t *target = (c % 2 ? odd.get() : r) + i;
+        if (chunk == bn)
+          mul_limbs(target, a + i, chunk, b, bn);
+        else
+          mul_limbs(target, b, bn, a + i, chunk);
+      }
+    });
+    add_n(r, r, an + bn, odd.get(), an + bn);
+    return;
+  }
+  limb_buffer product(2 * bn);
+  for (size_type i = 0; i < an; i += bn) {
+    const size_type chunk = std::min(bn, an - i);
+    if (chunk == bn)
+      mul_limbs(product.get(), a + i, chunk, b, bn);
+    else
+      mul_limbs(product.get(), b, bn, a + i, chunk);
+    // 只在乘积覆盖的范围内做加法，之后的进位单独传播
+    const limb_t carry = add_n(r + i, r + i, chunk + bn, product.get(),
+                               chunk + bn);
+    add_1(r + i + chunk + bn, an - i - chunk, carry);
+  }
+}
+
+auto BigInt::mul_karatsuba(value_type *r, const value_type *a, size_type an,
+                           const value_type *b, size_type bn) -> void {
+  // a = a1*B^h + a0, b = b1*B^h + b0, 由调用方保证bn > h
+  // a*b = z2*B^2h + (z0 + z2 - (a0-a1)(b0-b1))*B^h + z0
+  const size_type h = (an + 1) / 2;
+  const size_type a1n = an - h, b1n = bn - h;
+  limb_buffer buffer(6 * h + 1);
+  limb_t *da = buffer.get(), *db = da + h, *t = db + h, *mid = t + 2 * h;
+
+  const bool da_negative = abs_diff(da, a, h, a + h, a1n);
+  const bool db_negative = abs_diff(db, b, h, b + h, b1n);
+
+  // 三次子乘法写入互不重叠的位置，可以并行
+  const auto z0 = [=] { mul_limbs(r, a, h, b, h); };
+  const auto z2 = [=] { mul_limbs(r + 2 * h, a + h, a1n, b + h, b1n); };
+  const auto cross = [=] {
+    const size_type dan = normalized_length(da, h),
+                    dbn = normalized_length(db, h);
+    std::fill(t, t + 2 * h, 0);
+    if (dan >= dbn)
+      mul_limbs(t, da, dan, db, dbn);
+    else
+      mul_limbs(t, db, dbn, da, dan);
+  };
+  if (parallel_enabled(bn)) {
+    parallel_invoke(z0, z2, cross);
+  } else {
+    z0();
+    z2();
+    cross();
+  }
+
+  // mid = z0 + z2 ∓ t，结果等于a0*b1+a1*b0，非负
+  const size_type z2n = an + bn - 2 * h;
+  std::memcpy(mid, r, 2 * h * sizeof(limb_t));
+  mid[2 * h] = add_n(mid, mid, 2 * h, r + 2 * h, z2n);
+  if (da_negative == db_negative)
+    sub_n(mid, mid, 2 * h + 1, t, 2 * h);
+  else
+    add_n(mid, mid, 2 * h + 1, t, 2 * h);
+
+  // 中间项乘B^h后不会超过乘积范围，高位多余的limb必为0
+  const size_type midn = normalized_length(mid, 2 * h + 1);
+  [[maybe_unused]] const limb_t carry =
+      add_n(r + h, r + h, an + bn - h, mid, midn);
+  assert(!carry);
+}
+
+auto BigInt::sqr_karatsuba(value_type *r, const value_type *a, size_type n)
+    -> void {
+  // a^2 = z2*B^2h + (z0 + z2 - (a0-a1)^2)*B^h + z0，中间项一定非负
+  const size_type h = (n + 1) / 2;
+  const size_type a1n = n - h;
+  limb_buffer buffer(5 * h + 1);
+  limb_t *d = buffer.get(), *t = d + h, *mid = t + 2 * h;
+
+  abs_diff(d, a, h, a + h, a1n);
+  const auto z0 = [=] { sqr_limbs(r, a, h); };
+  const auto z2 = [=] { sqr_limbs(r + 2 * h, a + h, a1n); };
+  const auto cross = [=] {
+    const size_type dn = normalized_length(d, h);
+    std::fill(t + 2 * dn, t + 2 * h, 0);
+    sqr_limbs(t, d, dn);
+  };
+  if (parallel_enabled(n)) {
+    parallel_invoke(z0, z2, cross);
+  } else {
+    z0();
+    z2();
+    cross();
+  }
+
+  std::memcpy(mid, r, 2 * h * sizeof(limb_t));
+  mid[2 * h] = add_n(mid, mid, 2 * h, r + 2 * h, 2 * a1n);
+  sub_n(mid, mid, 2 * h + 1, t, 2 * h);
+
+  const size_type midn = normalized_length(mid, 2 * h + 1);
+  [[maybe_unused]] const limb_t carry =
+      add_n(r + h, r + h, 2 * n - h, mid, midn);
+  assert(!carry);
+}
+
+auto BigInt::mul_toom3(value_type *r, const value_type *a, size_type an,
+                       const value_type *b, size_type bn) -> void {
+  // a(x) = a2*x^2 + a1*x + a0，x = B^k，取值点0,1,-1,2,∞
+  // 中间结果有负数，直接借用BigInt的有符号运算，子乘法递归回到mul_limbs
+  const size_type k = (an + 2) / 3;
+  const BigInt a0{from_limbs(a, k)}, a1{from_limbs(a + k, k)},
+      a2{from_limbs(a + 2 * k, an - 2 * k)};
+  const BigInt pa{a0 + a2};
+  const BigInt a_p1{pa + a1}, a_m1{pa - a1};
+  const BigInt a_p2{(a_p1 + a2) * 2 - a0};
+
+  // 并行时子乘积在其他线程得到，结果对象从new/delete分配，
+  // 移动赋值只交换指针，不会在其他线程使用调用方的arena
+  const bool parallel = parallel_enabled(bn);
+  auto make_product = [parallel] {
+    if (!parallel)
+      return BigInt{};
+    const resource_scope scope{std::pmr::new_delete_resource()};
+    return BigInt{};
+  };
+  BigInt v0{make_product()}, v1{make_product()}, vm1{make_product()},
+      v2{make_product()}, vinf{make_product()};
+  // 五次子乘法互相独立
+  const auto products = [&](const BigInt &b0, const BigInt &b_p1,
+                            const BigInt &b_m1, const BigInt &b_p2,
+                            const BigInt &b2) {
+    const auto p0 = [&] { v0 = a0 * b0; };
+    const auto p1 = [&] { v1 = a_p1 * b_p1; };
+    const auto pm1 = [&] { vm1 = a_m1 * b_m1; };
+    const auto p2 = [&] { v2 = a_p2 * b_p2; };
+    const auto pinf = [&] { vinf = a2 * b2; };
+    if (parallel) {
+      parallel_invoke(p0, p1, pm1, p2, pinf);
+    } else {
+      p0();
+      p1();
+      pm1();
+      p2();
+      pinf();
+    }
+  };
+  // 平方时b的取值与a相同，五次子乘法都是平方
+  if (a == b && an == bn) {
+    products(a0, a_p1, a_m1, a_p2, a2);
+  } else {
+    const BigInt b0{from_limbs(b, k)}, b1{from_limbs(b + k, k)},
+        b2{from_limbs(b + 2 * k, bn - 2 * k)};
+    const BigInt pb{b0 + b2};
+    const BigInt b_p1{pb + b1}, b_m1{pb - b1};
+    const BigInt b_p2{(b_p1 + b2) * 2 - b0};
+    products(b0, b_p1, b_m1, b_p2, b2);
+  }
+
+  // 插值，除法均为整除
+  BigInt r3{(v2 - vm1) / 3};
+  BigInt r1{(v1 - vm1) / 2};
+  BigInt r2{vm1 - v0};
+  r3 = (r3 - r2) / 2 - r1 - vinf * 2;
+  r2 = r2 + r1 - vinf;
+  r1 = r1 - r3;
+
+  // 各项系数非负，依次累加到B^(i*k)位置
+  const size_type rn = an + bn;
+  std::fill(r, r + rn, 0);
+  const BigInt *coefficients[] = {&v0, &r1, &r2, &r3, &vinf};
+  for (size_type i = 0; i < 5; i++) {
+    const BigInt &c = *coefficients[i];
+    assert(!c.negative_);
+    if (c.Is_zero())
+      continue;
+    [[maybe_unused]] const limb_t carry =
+        add_n(r + i * k, r + i * k, rn - i * k, c.array_, c.length_);
+    assert(!carry);
+  }
+}
@@ -0,0 +1,258 @@
+// my_bigint_ntt.cpp
+// 三模数NTT乘法，CRT合并后结果精确
+#include "my_bigint_kernels.h"
+#include "my_bigint_parallel.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+
+using namespace my_bigint_detail;
+namespace {
+// 每个limb拆成两个16位系数，卷积系数最大为 min(na,nb)*(2^16-1)^2，
+// 三个素数之积约2^85，远大于系数上界
+constexpr int piece_bits = 16;
+constexpr limb_t piece_mask = (limb_t{1} << piece_bits) - 1;
+// 并行时变换长度不超过此值的部分在一个线程内完成
+constexpr size_type parallel_ntt_grain = size_type{1} << 15;
+
+template <std::uint32_t P, std::uint32_t G> struct ntt_prime {
+  static constexpr std::uint32_t mod = P;
+
+  static auto add(std::uint32_t x, std::uint32_t y) -> std::uint32_t {
+    const std::uint32_t s = x + y;
+    return s >= P ? s - P : s;
+  }
+  static auto sub(std::uint32_t x, std::uint32_t y) -> std::uint32_t {
+    return x >= y ? x - y : x + P - y;
+  }
+  // 模数为编译期常量，编译器把取模优化为乘法和移位
+  static auto mul(std::uint32_t x, std::uint32_t y) -> std::uint32_t {
+    return static_cast<std::uint32_t>(static_cast<std::uint64_t>(x) * y % P);
+  }
+  static auto pow(std::uint32_t x, std::uint64_t e) -> std::uint32_t {
+    std::uint32_t result = 1;
+    for (; e; e >>= 1, x = mul(x, x))
+      if (e & 1)
+        result = mul(result, x);
+    return result;
+  }
+
+  // roots[m + j] = w_{2m}^j，m为2的幂，同一层的单位根连续存放
+  static auto fill_roots(std::uint32_t *roots, size_type n, bool inverse)
+      -> void {
+    for (size_type m = 1; m < n; m <<= 1) {
+      std::uint32_t w = pow(G, (P - 1) / (2 * m));
+      if (inverse)
+        w = pow(w, P - 2);
+      std::uint32_t x = 1;
+      for (size_type j = 0; j < m; j++, x = mul(x, w))
+        roots[m + j] = x;
+    }
+  }
+  // DIF，输入自然序，输出位逆序
+  static auto forward(std::uint32_t *a, size_type n,
+                      const std::uint32_t *roots) -> void {
+    for (size_type m = n / 2; m >= 1; m >>= 1)
+      for (size_type s = 0; s < n; s += 2 * m)
+        for (size_type j = 0; j < m; j++) {
+          const std::uint32_t u = a[s + j], v = a[s + j + m];
+          a[s + j] = add(u, v);
+          a[s + j + m] = mul(sub(u, v), roots[m + j]);
+        }
+  }
+  // DIT，输入位逆序，输出自然序，含除以n
+  static auto inverse(std::uint32_t *a, size_type n,
+                      const std::uint32_t *roots) -> void {
+    for (size_type m = 1; m < n; m <<= 1)
+      for (size_type s = 0; s < n; s += 2 * m)
+        for (size_type j = 0; j < m; j++) {
+          const std::uint32_t u = a[s + j], v = mul(a[s + j + m], roots[m + j]);
+          a[s + j] = add(u, v);
+          a[s + j + m] = sub(u, v);
+        }
+    const std::uint32_t n_inverse = pow(static_cast<std::uint32_t>(n), P - 2);
+    for (size_type i = 0; i < n; i++)
+      a[i] = mul(a[i], n_inverse);
+  }
+
+  // 并行版本：DIF先做最外层蝶形，再分别变换两半，DIT顺序相反
+  // 两半使用的单位根与整体变换的低层相同
+  static auto forward_parallel(std::uint32_t *a, size_type n,
+                               const std::uint32_t *roots) -> void {
+    if (n <= parallel_ntt_grain) {
+      forward(a, n, roots);
+      return;
+    }
+    const size_type m = n / 2;
+    parallel_for(0, m, parallel_ntt_grain, [=](size_type lo, size_type hi) {
+      for (size_type j = lo; j < hi; j++) {
+        const std::uint32_t u = a[j], v = a[j + m];
+        a[j] = add(u, v);
+        a[j + m] = mul(sub(u, v), roots[m + j]);
+      }
+    });
+    parallel_invoke([=] { forward_parallel(a, m, roots); },
+                    [=] { forward_parallel(a + m, m, roots); });
+  }
+  // 不含除以n
+  static auto inverse_parallel(std::uint32_t *a, size_type n,
+                               const std::uint32_t *roots) -> void {
+    if (n <= parallel_ntt_grain) {
+      for (size_type m = 1; m < n; m <<= 1)
+        for (size_type s = 0; s < n; s += 2 * m)
+          for (size_type j = 0; j < m; j++) {
+            const std::uint32_t u = a[s + j],
+                                v = mul(a[s + j + m], roots[m + j]);
+            a[s + j] = add(u, v);
+            a[s + j + m] = sub(u, v);
+          }
+      return;
+    }
+    const size_type m = n / 2;
+    parallel_invoke([=] { inverse_parallel(a, m, roots); },
+                    [=] { inverse_parallel(a + m, m, roots); });
+    parallel_for(0, m, parallel_ntt_grain, [=](size_type lo, size_type hi) {
+      for (size_type j = lo; j < hi; j++) {
+        const std::uint32_t u = a[j], v = mul(a[j + m], roots[m + j]);
+        a[j] = add(u, v);
+        a[j + m] = sub(u, v);
+      }
+    });
+  }
+
+  // 把limb拆成16位系数放入f，不足n的部分补0
+  static auto load(std::uint32_t *f, size_type n, const limb_t *a,
+                   size_type an) -> void {
+    for (size_type i = 0; i < an; i++) {
+      f[2 * i] = a[i] & piece_mask;
+      f[2 * i + 1] = a[i] >> piece_bits;
+    }
+    std::fill(f + 2 * an, f + n, 0);
+  }
+  // 两个乘数的正变换并行，逐点相乘和逆变换按块并行
+  static auto convolve_parallel(std::uint32_t *out, std::uint32_t *temp,
+                                size_type n, std::uint32_t *roots,
+                                const limb_t *a, size_type an, const limb_t *b,
+                                size_type bn) -> void {
+    fill_roots(roots, n, false);
+    const bool square = a == b && an == bn;
+    const auto transform_a = [=] {
+      load(out, n, a, an);
+      forward_parallel(out, n, roots);
+    };
+    const auto transform_b = [=] {
+      load(temp, n, b, bn);
+      forward_parallel(temp, n, roots);
+    };
+    if (square)
+      transform_a();
+    else
+      parallel_invoke(transform_a, transform_b);
+    const std::uint32_t *other = square ? out : temp;
+    parallel_for(0, n, parallel_ntt_grain, [=](size_type lo, size_type hi) {
+      for (size_type i = lo; i < hi; i++)
+        out[i] = mul(out[i], other[i]);
+    });
+    fill_roots(roots, n, true);
+    inverse_parallel(out, n, roots);
+    const std::uint32_t n_inverse = pow(static_cast<std::uint32_t>(n), P - 2);
+    parallel_for(0, n, parallel_ntt_grain, [=](size_type lo, size_type hi) {
+      for (size_type i = lo; i < hi; i++)
+        out[i] = mul(out[i], n_inverse);
+    });
+  }
+  // out = a*b 在模P下的循环卷积，roots大小为n
+  static auto convolve(std::uint32_t *out, std::uint32_t *temp, size_type n,
+                       std::uint32_t *roots, const limb_t *a, size_type an,
+                       const limb_t *b, size_type bn) -> void {
+    fill_roots(roots, n, false);
+    load(out, n, a, an);
+    forward(out, n, roots);
+    if (a == b && an == bn) {
+      for (size_type i = 0; i < n; i++)
+        out[i] = mul(out[i], out[i]);
+    } else {
+      load(temp, n, b, bn);
+      forward(temp, n, roots);
+      for (size_type i = 0; i < n; i++)
+        out[i] = mul(out[i], temp[i]);
+    }
+    fill_roots(roots, n, true);
+    inverse(out, n, roots);
+  }
+};
+// 2-adic阶分别为2^26、2^25、2^24，最长变换长度2^24
+using prime0 = ntt_prime<469762049, 3>;
+using prime1 = ntt_prime<167772161, 3>;
+using prime2 = ntt_prime<754974721, 11>;
+// 三个模数下的卷积按CRT合并，逐系数进位后两两拼成limb写入r
+auto garner(limb_t *r, const std::uint32_t *c0, const std::uint32_t *c1,
+            const std::uint32_t *c2, size_type pieces) -> void {
+  // Garner算法：x = r0 + p0*t1 + p0*p1*t2
+  constexpr std::uint64_t p0 = prime0::mod, p1 = prime1::mod;
+  const std::uint32_t p0_inverse_mod_p1 =
+      prime1::pow(static_cast<std::uint32_t>(p0 % p1), prime1::mod - 2);
+  const std::uint32_t p01_inverse_mod_p2 = prime2::pow(
+      static_cast<std::uint32_t>(p0 * p1 % prime2::mod), prime2::mod - 2);
+  const std::uint32_t p0_mod_p2 = static_cast<std::uint32_t>(p0 % prime2::mod);
+
+  uint128_t carry = 0;
+  for (size_type i = 0; i < pieces; i++) {
+    if (i < pieces - 1) {
+      const std::uint32_t r0 = c0[i];
+      const std::uint32_t t1 =
+          prime1::mul(prime1::sub(c1[i], r0 % prime1::mod), p0_inverse_mod_p1);
+      const std::uint64_t x01 = r0 + p0 * t1;
+      const std::uint32_t x01_mod_p2 = prime2::add(
+          r0 % prime2::mod, prime2::mul(t1 % prime2::mod, p0_mod_p2));
+      const std::uint32_t t2 = prime2::mul(prime2::sub(c2[i], x01_mod_p2),
+                                           p01_inverse_mod_p2);
+      carry += x01 + static_cast<uint128_t>(p0 * p1) * t2;
+    }
+    // 每个系数对应16位，两两拼成一个limb
+    const limb_t piece = static_cast<limb_t>(carry) & piece_mask;
+    carry >>= piece_bits;
+    if (i % 2 == 0)
+      r[i / 2] = piece;
+    else
+      r[i / 2] |= piece << piece_bits;
+  }
+  assert(!carry);
+}
+} // namespace
+
+auto my_bigint_detail::mul_ntt(limb_t *r, const limb_t *a, size_type an,
+                               const limb_t *b, size_type bn) -> void {
+  assert(an + bn <= ntt_max_limbs);
+  const size_type pieces = 2 * (an + bn);
+  size_type n = 1;
+  while (n < pieces - 1)
+    n <<= 1;
+
+  if (parallel_enabled(bn)) {
+    // 三个模数同时计算，各自需要第二个乘数和单位根的空间
+    limb_buffer buffer(9 * n);
+    std::uint32_t *c0 = buffer.get(), *c1 = c0 + n, *c2 = c1 + n,
+                  *temp = c2 + n, *roots = temp + 3 * n;
+    parallel_invoke(
+        [=] { prime0::convolve_parallel(c0, temp, n, roots, a, an, b, bn); },
+        [=] {
+          prime1::convolve_parallel(c1, temp + n, n, roots + n, a, an, b, bn);
+        },
+        [=] {
+          prime2::convolve_parallel(c2, temp + 2 * n, n, roots + 2 * n, a, an,
+                                    b, bn);
+        });
+    garner(r, c0, c1, c2, pieces);
+    return;
+  }
+  // 三个模数的结果各占n，另有n用于第二个乘数、n用于单位根
+  limb_buffer buffer(5 * n);
+  std::uint32_t *c0 = buffer.get(), *c1 = c0 + n, *c2 = c1 + n,
+                *temp = c2 + n, *roots = temp + n;
+  prime0::convolve(c0, temp, n, roots, a, an, b, bn);
+  prime1::convolve(c1, temp, n, roots, a, an, b, bn);
+  prime2::convolve(c2, temp, n, roots, a, an, b, bn);
+  garner(r, c0, c1, c2, pieces);
+}
+
@@ -0,0 +1,191 @@
+// my_bigint_parallel.cpp
+// 工作窃取线程池：每个工作线程有自己的任务队列，从队尾取自己提交的任务，
+// 空闲时从其他队列的队首窃取；等待子任务的线程不阻塞，继续执行池中的任务
+#include "my_bigint_parallel.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace my_bigint_detail;
+namespace {
+class thread_pool {
+  struct job_queue {
+    std::mutex mutex;
+    std::deque<parallel_job *> jobs;
+  };
+  // 下标0给不属于线程池的调用线程共用，其余每个工作线程一个
+  std::vector<std::unique_ptr<job_queue>> queues_;
+  std::vector<std::thread> workers_;
+  // 所有队列中的任务总数，工作线程据此决定是否睡眠
+  std::atomic<size_type> queued_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+
+  // 当前线程在哪个线程池的哪个队列，不属于任何线程池时为nullptr
+  static thread_local const thread_pool *current_pool_;
+  static thread_local size_type current_queue_;
+
+  [[nodiscard]] auto own_queue() const noexcept -> size_type {
+    return current_pool_ == this ? current_queue_ : 0;
+  }
+  // 先取自己队尾最近提交的任务，数据还在缓存里；再从其他队首窃取较大的任务
+  auto find_job() -> parallel_job * {
+    const size_type self = own_queue();
+    {
+      job_queue &queue = *queues_[self];
+      const std::lock_guard lock{queue.mutex};
+      if (!queue.jobs.empty()) {
+        parallel_job *job = queue.jobs.back();
+        queue.jobs.pop_back();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+      }
+    }
+    for (size_type i = 1; i < queues_.size(); i++) {
+      job_queue &queue = *queues_[(self + i) % queues_.size()];
+      const std::lock_guard lock{queue.mutex};
+      if (!queue.jobs.empty()) {
+        parallel_job *job = queue.jobs.front();
+        queue.jobs.pop_front();
+        queued_.fetch_sub(1, std::memory_order_relaxed);
+        return job;
+      }
+    }
+    return nullptr;
+  }
+  // 任务结束后不能再访问job，发起方可能已经返回
+  static auto execute(parallel_job *job) -> void {
+    job_group &group = *job->group;
+    {
+      const BigInt::resource_scope scope{std::pmr::new_delete_resource()};
+      [[maybe_unused]] const operation_override inherited{group.operation};
+      try {
+        job->invoke(job->function);
+      } catch (...) {
+        if (!group.failed.exchange(true))
+          group.error = std::current_exception();
+      }
+    }
+    group.pending.fetch_sub(1, std::memory_order_release);
+  }
+  auto work(size_type index) -> void {
+    current_pool_ = this;
+    current_queue_ = index;
+    for (;;) {
+      if (parallel_job *job = find_job()) {
+        execute(job);
+        continue;
+      }
+      std::unique_lock lock{sleep_mutex_};
+      wake_.wait(lock, [this] {
+        return stopping_ || queued_.load(std::memory_order_relaxed) > 0;
+      });
+      if (stopping_)
+        return;
+    }
+  }
+
+public:
+  explicit thread_pool(size_type workers) {
+    for (size_type i = 0; i <= workers; i++)
+      queues_.push_back(std::make_unique<job_queue>());
+    workers_.reserve(workers);
+    for (size_type i = 1; i <= workers; i++)
+      workers_.emplace_back([this, i] { work(i); });
+  }
+  ~thread_pool() {
+    {
+      const std::lock_guard lock{sleep_mutex_};
+      stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread &worker : workers_)
+      worker.join();
+  }
+  thread_pool(const thread_pool &) = delete;
+  auto operator=(const thread_pool &) -> thread_pool & = delete;
+  [[nodiscard]] auto threads() const noexcept -> size_type {
+    return workers_.size() + 1;
+  }
+
+  auto run(parallel_job *jobs, size_type n) -> void {
+    job_group group;
+    group.pending.store(n - 1, std::memory_order_relaxed);
+    {
+      job_queue &queue = *queues_[own_queue()];
+      const std::lock_guard lock{queue.mutex};
+      for (size_type i = 1; i < n; i++) {
+        jobs[i].group = &group;
+        queue.jobs.push_back(&jobs[i]);
+      }
+    }
+    queued_.fetch_add(n - 1, std::memory_order_relaxed);
+    {
+      // 与工作线程检查queued_互斥，避免通知丢失
+      const std::lock_guard lock{sleep_mutex_};
+    }
+    for (size_type i = 1; i < n; i++)
+      wake_.notify_one();
+
+    std::exception_ptr error;
+    try {
+      jobs[0].invoke(jobs[0].function);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    // 栈上的任务被其他线程引用，出现异常也要等全部完成
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+      if (parallel_job *job = find_job())
+        execute(job);
+      else
+        std::this_thread::yield();
+    }
+    if (error)
+      std::rethrow_exception(error);
+    if (group.failed.load())
+      std::rethrow_exception(group.error);
+  }
+};
+thread_local const thread_pool *thread_pool::current_pool_ = nullptr;
+thread_local size_type thread_pool::current_queue_ = 0;
+
+std::mutex pool_mutex;
+std::unique_ptr<thread_pool> pool_owner;
+std::atomic<thread_pool *> active_pool{nullptr};
+std::atomic<size_type> parallel_cutoff{BigInt::default_parallel_cutoff};
+} // namespace
+
+auto my_bigint_detail::parallel_enabled(size_type limbs) noexcept -> bool {
+  return active_pool.load(std::memory_order_relaxed) &&
+         limbs >= parallel_cutoff.load(std::memory_order_relaxed);
+}
+
+auto my_bigint_detail::run_jobs(parallel_job *jobs, size_type n) -> void {
+  thread_pool *pool = active_pool.load(std::memory_order_acquire);
+  if (!pool || n == 1) {
+    for (size_type i = 0; i < n; i++)
+      jobs[i].invoke(jobs[i].function);
+    return;
+  }
+  pool->run(jobs, n);
+}
+
+auto BigInt::set_parallel(size_type threads, size_type cutoff_limbs) -> void {
+  const std::lock_guard lock{pool_mutex};
+  active_pool.store(nullptr);
+  pool_owner.reset();
+  parallel_cutoff.store(cutoff_limbs);
+  if (threads > 1) {
+    pool_owner = std::make_unique<thread_pool>(threads - 1);
+    active_pool.store(pool_owner.get());
+  }
+}
+
+auto BigInt::parallel_threads() noexcept -> size_type {
+  const thread_pool *pool = active_pool.load();
+  return pool ? pool->threads() : 1;
+}
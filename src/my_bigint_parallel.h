@@ -0,0 +1,60 @@
+// my_bigint_parallel.h
+// 内部使用的线程池接口，只在src内包含，实现见my_bigint_parallel.cpp
+#ifndef MY_BIGINT_PARALLEL_H
+#define MY_BIGINT_PARALLEL_H
+#include "my_bigint.h"
+#include "my_bigint_instrument.h"
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <type_traits>
+
+namespace my_bigint_detail {
+using size_type = BigInt::size_type;
+
+// 一组同时提交的任务，发起方等待pending归零，第一个异常在等待结束后重新抛出
+struct job_group {
+  std::atomic<size_type> pending{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  // 发起方正在统计的运算，其他线程执行任务时沿用
+  int operation = active_operation();
+};
+// 任务由发起方在栈上构造，发起方等待全部完成后才返回，执行期间一直有效
+struct parallel_job {
+  auto (*invoke)(void *function) -> void;
+  void *function;
+  job_group *group = nullptr;
+  template <class F>
+  explicit parallel_job(F &f)
+      : invoke{[](void *p) { (*static_cast<F *>(p))(); }},
+        function{const_cast<std::remove_const_t<F> *>(std::addressof(f))} {}
+};
+
+// 线程池已开启，且子问题的limb数达到BigInt::set_parallel设置的阈值
+[[nodiscard]] auto parallel_enabled(size_type limbs) noexcept -> bool;
+// jobs[0]在当前线程执行，其余交给线程池；等待期间当前线程也执行池中的任务
+// 其他线程上的任务在new/delete资源下执行，不会并发使用调用方的arena
+auto run_jobs(parallel_job *jobs, size_type n) -> void;
+
+// 并行执行所有函数，全部完成后返回
+template <class... F> auto parallel_invoke(F &&...functions) -> void {
+  parallel_job jobs[] = {parallel_job{functions}...};
+  run_jobs(jobs, sizeof...(F));
+}
+// 把[begin,end)二分到不超过grain的区间，对每个区间并行调用f(lo, hi)
+template <class F>
+auto parallel_for(size_type begin, size_type end, size_type grain, const F &f)
+    -> void {
+  if (end - begin <= grain) {
+    f(begin, end);
+    return;
+  }
+  const size_type middle = begin + (end - begin) / 2;
+  parallel_invoke([&] { parallel_for(begin, middle, grain, f); },
+                  [&] { parallel_for(middle, end, grain, f); });
+}
+} // namespace my_bigint_detail
+
+#endif // MY_BIGINT_PARALLEL_H
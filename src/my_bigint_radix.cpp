@@ -0,0 +1,252 @@
+// my_bigint_radix.cpp
+// 十进制与2^32进制互转，长数字按10^(9*2^k)分治
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+
+using namespace my_bigint_detail;
+namespace {
+// 每次处理9位十进制数
+constexpr limb_t decimal_chunk = 1'000'000'000;
+constexpr size_type decimal_chunk_digits = 9;
+// 低于阈值时逐块乘加/除以10^9，O(n^2)但常数小
+constexpr size_type parse_threshold_digits = 3000;
+constexpr size_type print_threshold_limbs = 300;
+
+// 10^(9*2^k)及其倒数，按需平方生成，多线程共享
+// deque扩展时已有元素地址不变，返回的引用一直有效
+struct decimal_power_entry {
+  BigInt power;
+  // 打印时反复除以同一个power，缓存倒数后每次除法只需两次乘法
+  BigInt reciprocal;
+  std::once_flag reciprocal_once;
+  explicit decimal_power_entry(BigInt value) : power{std::move(value)} {}
+};
+// 缓存一直存在，不能从调用方可能设置的arena分配
+auto decimal_power_at(size_type k) -> decimal_power_entry & {
+  static std::deque<decimal_power_entry> table;
+  static std::mutex table_mutex;
+  const std::lock_guard lock{table_mutex};
+  const BigInt::resource_scope scope{std::pmr::new_delete_resource()};
+  while (table.size() <= k)
+    table.emplace_back(table.empty()
+                           ? BigInt{decimal_chunk}
+                           : table.back().power * table.back().power);
+  return table[k];
+}
+auto decimal_power(size_type k) -> const BigInt & {
+  return decimal_power_at(k).power;
+}
+// decimal_power(k)的十进制位数减1
+constexpr auto power_digits(size_type k) -> size_type {
+  return decimal_chunk_digits << k;
+}
+auto parse_chunk(const char *digits, size_type n) -> limb_t {
+  limb_t chunk = 0;
+  for (size_type i = 0; i < n; i++)
+    chunk = chunk * 10 + static_cast<limb_t>(digits[i] - '0');
+  return chunk;
+}
+// 不超过parse_threshold_digits位，逐块乘加写入out，返回去掉高位0之前的limb数
+// out至少digits.size()/9+1个limb
+auto parse_basecase(limb_t *out, std::string_view digits) -> size_type {
+  // 字符串大端序，每9位十进制数做一次 x = x*10^9 + chunk
+  // 第一段长度取余数，保证后续每段都是9位
+  size_type length = 1;
+  out[0] = 0;
+  size_type chunk_length = digits.size() % decimal_chunk_digits;
+  if (!chunk_length)
+    chunk_length = decimal_chunk_digits;
+  limb_t multiplier = 1;
+  for (size_type i = 0; i < chunk_length; i++)
+    multiplier *= 10;
+  while (!digits.empty()) {
+    const limb_t chunk = parse_chunk(digits.data(), chunk_length);
+    digits.remove_prefix(chunk_length);
+    const limb_t carry = mul_1(out, out, length, multiplier, chunk);
+    if (carry)
+      out[length++] = carry;
+    chunk_length = decimal_chunk_digits;
+    multiplier = decimal_chunk;
+  }
+  return length;
+}
+// 恰好写n位，高位补0
+auto write_chunk(char *out, limb_t chunk, size_type n) -> void {
+  for (size_type i = n; i-- > 0;) {
+    out[i] = static_cast<char>('0' + chunk % 10);
+    chunk /= 10;
+  }
+}
+} // namespace
+
+auto BigInt::from_decimal(std::string_view digits) -> BigInt {
+  if (digits.size() > parse_threshold_digits) {
+    // 低半部分恰好9*2^k位，高半部分不超过低半部分
+    size_type k = 0;
+    while (power_digits(k + 1) < digits.size())
+      ++k;
+    const size_type split = digits.size() - power_digits(k);
+    return from_decimal(digits.substr(0, split)) * decimal_power(k) +
+           from_decimal(digits.substr(split));
+  }
+  BigInt result(0, digits.size() / decimal_chunk_digits + 1);
+  result.getLength(parse_basecase(result.array_, digits));
+  return result;
+}
+
+auto BigInt::write_decimal(char *out, const BigInt &x, size_type width,
+                           const char *last) -> char * {
+  if (x.length_ > print_threshold_limbs) {
+    // 选k使x < 10^(9*2^k)的平方，商和余数都小于10^(9*2^k)，分别递归
+    // 除顶层外width恰好是9*2^(k+1)，两半等长
+    size_type k = 0;
+    if (width) {
+      while (power_digits(k + 1) < width)
+        ++k;
+    } else {
+      const size_type estimate = x.length_ * 964 / 100 + 1; // 32*log10(2)≈9.63
+      while (2 * power_digits(k) < estimate)
+        ++k;
+      // 估计可能偏大，保证商不为0，否则会对同一个数无限递归
+      while (k > 0 && x.cmp_abs_less(decimal_power(k)))
+        --k;
+    }
+    decimal_power_entry &entry = decimal_power_at(k);
+    std::call_once(entry.reciprocal_once, [&entry] {
+      const resource_scope scope{std::pmr::new_delete_resource()};
+      entry.reciprocal = reciprocal(entry.power);
+    });
+    const bigInt_division_result parts{
+        divide_barrett(abs(x), entry.power, entry.reciprocal)};
+    const size_type low_digits = power_digits(k);
+    if (width) {
+      out = write_decimal(out, parts.quotient, width - low_digits, last);
+    } else if (!parts.quotient.Is_zero()) {
+      // 余数恰好low_digits位，商只能用前面的空间
+      if (static_cast<size_type>(last - out) < low_digits)
+        return nullptr;
+      out = write_decimal(out, parts.quotient, 0, last - low_digits);
+      if (!out)
+        return nullptr;
+    } else {
+      return write_decimal(out, parts.remainder, 0, last);
+    }
+    return write_decimal(out, parts.remainder, low_digits, last);
+  }
+
+  // 反复除以10^9，得到从低到高的9位十进制块，不超过阈值的数在栈上计算
+  // 每个limb约9.63位十进制数，块数不超过limb数的1.1倍加1
+  limb_t temp[print_threshold_limbs];
+  limb_t chunks[print_threshold_limbs * 11 / 10 + 2];
+  std::memcpy(temp, x.array_, x.length_ * sizeof(limb_t));
+  size_type temp_length = x.length_, count = 0;
+  while (temp_length > 1 || temp[0]) {
+    chunks[count++] = divmod_1(temp, temp, temp_length, decimal_chunk);
+    temp_length = normalized_length(temp, temp_length);
+  }
+  if (width) {
+    assert(count * decimal_chunk_digits <= width);
+    const size_type zeros = width - count * decimal_chunk_digits;
+    std::memset(out, '0', zeros);
+    out += zeros;
+  } else if (!count) {
+    if (out == last)
+      return nullptr;
+    *out++ = '0';
+    return out;
+  } else {
+    // 最高块不补0，位数确定后才知道是否放得下
+    --count;
+    size_type top_digits = 1;
+    for (limb_t top = chunks[count]; top >= 10; top /= 10)
+      ++top_digits;
+    if (static_cast<size_type>(last - out) <
+        top_digits + count * decimal_chunk_digits)
+      return nullptr;
+    write_chunk(out, chunks[count], top_digits);
+    out += top_digits;
+  }
+  while (count-- > 0) {
+    write_chunk(out, chunks[count], decimal_chunk_digits);
+    out += decimal_chunk_digits;
+  }
+  return out;
+}
+
+auto BigInt::to_string() const -> std::string {
+  std::string result(length_ * 10 + 2, '\0');
+  char *out = result.data();
+  if (negative_)
+    *out++ = '-';
+  out = write_decimal(out, *this, 0, result.data() + result.size());
+  result.resize(static_cast<size_type>(out - result.data()));
+  return result;
+}
+
+auto to_chars(char *first, char *last, const BigInt &N)
+    -> std::to_chars_result {
+  const auto available = static_cast<size_type>(last - first);
+  const size_type sign = N.negative_ ? 1 : 0;
+  if (N.length_ <= BigInt::initial_size<std::uintmax_t>) {
+    if (available <= sign)
+      return {last, std::errc::value_too_large};
+    if (sign)
+      *first++ = '-';
+    return std::to_chars(first, last, N.low_word());
+  }
+  // 2^(bits-1) <= |N| < 2^bits，log10(2)≈0.30103，位数最多相差1
+  const size_type bits = (N.length_ - 1) * limb_bits +
+                         static_cast<size_type>(
+                             std::bit_width(N.array_[N.length_ - 1]));
+  const size_type min_digits = (bits - 1) * 30102 / 100000 + 1;
+  if (available < sign + min_digits)
+    return {last, std::errc::value_too_large};
+  if (sign)
+    *first++ = '-';
+  // 只差一位时由write_decimal在确定最高块的位数后判断，直接写入[first,last)
+  if (char *end = BigInt::write_decimal(first, N, 0, last))
+    return {end, std::errc{}};
+  return {last, std::errc::value_too_large};
+}
+auto from_chars(const char *first, const char *last, BigInt &N)
+    -> std::from_chars_result {
+  const bool negative = first != last && *first == '-';
+  const char *begin = negative ? first + 1 : first;
+  const char *end = std::find_if_not(
+      begin, last, [](char c) { return c >= '0' && c <= '9'; });
+  if (begin == end)
+    return {first, std::errc::invalid_argument};
+  const std::string_view digits{begin, end};
+  if (digits.size() > parse_threshold_digits) {
+    N = BigInt::from_decimal(digits);
+  } else {
+    // 原有内容不再需要，扩容时不复制
+    N.length_ = 1;
+    N.reserve(digits.size() / decimal_chunk_digits + 1);
+    N.getLength(parse_basecase(N.array_, digits));
+  }
+  N.negative_ = negative;
+  N.un_negative_zero();
+  return {end, std::errc{}};
+}
+auto operator<<(std::ostream &out, const BigInt &N) -> std::ostream & {
+  // 短数字写入栈上的缓冲区，长数字写入一次分配的临时缓冲区
+  char small[256];
+  if (const auto [end, ec] = to_chars(small, small + sizeof(small), N);
+      ec == std::errc{})
+    return out << std::string_view{small, end};
+  const size_type capacity = N.length_ * 10 + 2;
+  limb_buffer buffer(capacity / sizeof(limb_t) + 1);
+  char *text = reinterpret_cast<char *>(buffer.get());
+  const auto [end, ec] = to_chars(text, text + capacity, N);
+  return out << std::string_view{text, end};
+}
@@ -0,0 +1,263 @@
+// my_bigint_root.cpp
+// 整数平方根、k次方根和完全幂判断：由高位部分递归求出一半精度的近似值，
+// 再做一步牛顿迭代使精度翻倍，最后一层的一次除法和一次乘方占了大部分开销
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace my_bigint_detail;
+namespace {
+// 根不超过这么多位时直接由浮点数估计，再用乘方修正
+constexpr size_type small_root_bits = 32;
+// 完全幂判断中每个指数检验的素数个数，以及一次遍历同时检验的素数个数
+constexpr int residue_tests = 3;
+constexpr size_type residue_batch = 8;
+
+// 64位整数的平方根，浮点数估计后修正
+auto sqrt_word(std::uint64_t n) -> std::uint64_t {
+  auto r = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(n)));
+  while (static_cast<uint128_t>(r) * r > n)
+    r--;
+  while (static_cast<uint128_t>(r + 1) * (r + 1) <= n)
+    r++;
+  return r;
+}
+// 32位以内的素数，试除即可
+auto is_small_prime(std::uint64_t p) -> bool {
+  if (p < 2)
+    return false;
+  for (std::uint64_t d = 2; d * d <= p; d++)
+    if (p % d == 0)
+      return false;
+  return true;
+}
+auto powmod_word(std::uint64_t base, std::uint64_t exponent, std::uint64_t p)
+    -> std::uint64_t {
+  std::uint64_t result = 1;
+  for (; exponent; exponent >>= 1) {
+    if (exponent & 1)
+      result = result * base % p;
+    base = base * base % p;
+  }
+  return result;
+}
+// base^exponent mod 2^64
+auto pow_word(std::uint64_t base, std::uint64_t exponent) -> std::uint64_t {
+  std::uint64_t result = 1;
+  for (; exponent; exponent >>= 1) {
+    if (exponent & 1)
+      result *= base;
+    base *= base;
+  }
+  return result;
+}
+// 不超过n的素数
+auto primes_up_to(size_type n) -> std::vector<size_type> {
+  std::vector<bool> composite(n + 1);
+  std::vector<size_type> primes;
+  for (size_type i = 2; i <= n; i++) {
+    if (composite[i])
+      continue;
+    primes.push_back(i);
+    for (size_type j = i * i; j <= n; j += i)
+      composite[j] = true;
+  }
+  return primes;
+}
+} // namespace
+
+// 所有运算都在非负数上进行
+class BigInt::root_engine {
+public:
+  static auto bit_length(const BigInt &N) -> size_type {
+    return (N.length_ - 1) * limb_bits +
+           static_cast<size_type>(std::bit_width(N.array_[N.length_ - 1]));
+  }
+  static auto trailing_zeros(const BigInt &N) -> size_type {
+    size_type i = 0;
+    while (!N.array_[i])
+      i++;
+    return i * limb_bits +
+           static_cast<size_type>(std::countr_zero(N.array_[i]));
+  }
+  // 一次遍历同时求N模count个素数的余数，各个取模互不依赖，可以流水执行
+  // 用预先算好的floor(2^64/p)乘法代替除法，估计的商最多偏小2
+  static auto mod_words(const BigInt &N, const limb_t *p, size_type count,
+                        limb_t *remainders) -> void {
+    wide_t r[residue_batch] = {}, inverse[residue_batch];
+    for (size_type j = 0; j < count; j++)
+      inverse[j] = UINT64_MAX / p[j];
+    for (size_type i = N.length_; i-- > 0;) {
+      for (size_type j = 0; j < count; j++) {
+        const wide_t x = (r[j] << limb_bits) | N.array_[i];
+        const auto q =
+            static_cast<wide_t>((static_cast<uint128_t>(x) * inverse[j]) >> 64);
+        wide_t rest = x - q * p[j];
+        while (rest >= p[j])
+          rest -= p[j];
+        r[j] = rest;
+      }
+    }
+    for (size_type j = 0; j < count; j++)
+      remainders[j] = static_cast<limb_t>(r[j]);
+  }
+  // 由最高三个limb估计log2(N)，双精度足以让32位以内的根误差不超过1
+  static auto log2(const BigInt &N) -> double {
+    const size_type used = std::min<size_type>(N.length_, 3);
+    double top = 0;
+    for (size_type i = N.length_; i-- > N.length_ - used;)
+      top = top * 0x1p32 + N.array_[i];
+    return std::log2(top) + static_cast<double>((N.length_ - used) * limb_bits);
+  }
+
+  static auto sqrt(const BigInt &N) -> BigInt {
+    const size_type bits = bit_length(N);
+    if (bits <= 64)
+      return BigInt{sqrt_word(N.low_word())};
+    // 高bits-2h位的平方根约有bits/4位，作为近似值的相对误差约为2^(-bits/4)
+    const size_type h = bits / 4;
+    BigInt x{(sqrt(N >> (2 * h)) + 1) << h};
+    // 从上方出发的一步牛顿迭代仍不小于真值，误差只剩几个单位
+    x = (x + N / x) >> 1;
+    BigInt remainder{N - x.square()};
+    while (remainder.negative_) {
+      // (x-1)^2 = x^2 - 2x + 1
+      remainder += x << 1;
+      remainder -= 1;
+      x -= 1;
+    }
+    return x;
+  }
+  static auto estimate_root(const BigInt &N, size_type k) -> std::uint64_t {
+    return static_cast<std::uint64_t>(
+        std::exp2(log2(N) / static_cast<double>(k)));
+  }
+  static auto small_root(const BigInt &N, size_type k) -> BigInt {
+    std::uint64_t x = estimate_root(N, k);
+    while (x > 0 && pow(BigInt{x}, k) > N)
+      x--;
+    while (pow(BigInt{x + 1}, k) <= N)
+      x++;
+    return BigInt{x};
+  }
+  // k>=3
+  static auto root(const BigInt &N, size_type k) -> BigInt {
+    if (N.Is_zero())
+      return BigInt{0};
+    // 根小于2^root_bits
+    const size_type root_bits = (bit_length(N) - 1) / k + 1;
+    if (root_bits <= small_root_bits)
+      return small_root(N, k);
+    // 牛顿迭代一步后的误差约为(k-1)/2*r*e^2，多留log2(k)位使其只有几个单位
+    const auto margin = static_cast<size_type>(std::bit_width(k));
+    const size_type h =
+        root_bits > margin + 2 ? (root_bits - margin) / 2 : size_type{1};
+    BigInt x{(root(N >> (k * h), k) + 1) << h};
+    // 从上方出发单调下降，不再下降时即为结果
+    for (;;) {
+      BigInt y{(x * (k - 1) + N / pow(x, k - 1)) / k};
+      if (y >= x)
+        return x;
+      x = std::move(y);
+    }
+  }
+  // N是k次幂时，N模每个素数p≡1 (mod k)都是k次剩余，N^((p-1)/k) ≡ 0或1
+  // 每个素数排除约1-1/k的非k次幂，代价只是一次O(n)的取模；
+  // 逐轮检验，每轮只对上一轮剩下的指数取下一个素数，几个指数共用一次遍历
+  static auto filter_powers(const BigInt &N, std::vector<size_type> exponents)
+      -> std::vector<size_type> {
+    std::vector<std::uint64_t> last(exponents.size(), 1);
+    for (int round = 0; round < residue_tests; round++) {
+      std::vector<size_type> kept;
+      std::vector<std::uint64_t> kept_last;
+      for (size_type start = 0; start < exponents.size();
+           start += residue_batch) {
+        const size_type count =
+            std::min(residue_batch, exponents.size() - start);
+        limb_t p[residue_batch], r[residue_batch];
+        for (size_type j = 0; j < count; j++) {
+          // 下一个模2k余1的素数，超出32位就不再检验
+          const std::uint64_t step = 2 * exponents[start + j];
+          std::uint64_t q = last[start + j] + step;
+          while (q <= UINT32_MAX && !is_small_prime(q))
+            q += step;
+          last[start + j] = q;
+          p[j] = q <= UINT32_MAX ? static_cast<limb_t>(q) : 1;
+        }
+        mod_words(N, p, count, r);
+        for (size_type j = 0; j < count; j++) {
+          const size_type k = exponents[start + j];
+          if (p[j] == 1 || !r[j] ||
+              powmod_word(r[j], (p[j] - 1) / k, p[j]) == 1) {
+            kept.push_back(k);
+            kept_last.push_back(last[start + j]);
+          }
+        }
+      }
+      exponents = std::move(kept);
+      last = std::move(kept_last);
+    }
+    return exponents;
+  }
+  // 根不超过32位时估计值的误差不超过1，先比较最低64位，相同时再做完整的乘方
+  static auto is_small_power(const BigInt &N, size_type k) -> bool {
+    const std::uint64_t x = estimate_root(N, k);
+    for (std::uint64_t c = x > 2 ? x - 1 : 2; c <= x + 1; c++)
+      if (pow_word(c, k) == N.low_word() && pow(BigInt{c}, k) == N)
+        return true;
+    return false;
+  }
+};
+
+auto BigInt::isqrt(const BigInt &N) -> BigInt {
+  if (N.negative_)
+    throw std::invalid_argument{"square root of a negative number"};
+  return root_engine::sqrt(N);
+}
+auto BigInt::iroot(const BigInt &N, size_type k) -> BigInt {
+  if (!k)
+    throw std::invalid_argument{"zeroth root"};
+  if (N.negative_ && k % 2 == 0)
+    throw std::invalid_argument{"even root of a negative number"};
+  if (k == 1)
+    return N;
+  // 负数的奇数次方根向零取整，与除法一致
+  BigInt result{k == 2 ? root_engine::sqrt(N) : root_engine::root(abs(N), k)};
+  if (N.negative_) {
+    result.negative_ = true;
+    result.un_negative_zero();
+  }
+  return result;
+}
+auto BigInt::is_perfect_power(const BigInt &N) -> bool {
+  const BigInt M{abs(N)};
+  // 0、1、-1
+  if (M <= 1)
+    return true;
+  // M = 2^t * 奇数，M = b^k时k整除t；奇数时t为0，没有限制
+  const size_type t = root_engine::trailing_zeros(M);
+  // 只需检查素数指数，负数只能是奇数次幂
+  const size_type bits = root_engine::bit_length(M);
+  // 根不超过32位的指数直接由估计值判断，其余先用剩余检验筛选
+  std::vector<size_type> exponents;
+  for (size_type k : primes_up_to(bits)) {
+    if ((N.negative_ && k == 2) || (t && t % k))
+      continue;
+    if ((bits - 1) / k + 1 > small_root_bits)
+      exponents.push_back(k);
+    else if (root_engine::is_small_power(M, k))
+      return true;
+  }
+  for (size_type k : root_engine::filter_powers(M, std::move(exponents))) {
+    const BigInt r{k == 2 ? root_engine::sqrt(M) : root_engine::root(M, k)};
+    if (pow(r, k) == M)
+      return true;
+  }
+  return false;
+}
@@ -0,0 +1,259 @@
+// my_bigint_serialize.cpp
+// 二进制序列化和只读视图：头部逐字节按小端序读写，与机器字节序无关；
+// 小端序机器上limb与内存布局相同，整段复制，视图直接引用
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#define MY_BIGINT_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace my_bigint_detail;
+namespace {
+constexpr char magic[4] = {'B', 'I', 'G', 'I'};
+constexpr std::uint16_t negative_flag = 1;
+constexpr size_type header_size = BigInt::serialization_header_size;
+constexpr bool native_limbs = std::endian::native == std::endian::little;
+// 从流读取时每次读入的limb数
+constexpr size_type load_chunk_limbs = size_type{1} << 16;
+
+template <std::unsigned_integral T>
+auto store_le(std::byte *out, T value) noexcept -> void {
+  for (size_type i = 0; i < sizeof(T); i++)
+    out[i] = static_cast<std::byte>(value >> (8 * i));
+}
+template <std::unsigned_integral T>
+auto load_le(const std::byte *in) noexcept -> T {
+  T value = 0;
+  for (size_type i = 0; i < sizeof(T); i++)
+    value |= static_cast<T>(std::to_integer<T>(in[i]) << (8 * i));
+  return value;
+}
+
+struct header {
+  bool negative;
+  size_type length;
+};
+auto write_header(std::byte *out, bool negative, size_type length) noexcept
+    -> void {
+  std::memcpy(out, magic, sizeof(magic));
+  store_le(out + 4, BigInt::serialization_version);
+  store_le(out + 6, negative ? negative_flag : std::uint16_t{0});
+  store_le(out + 8, static_cast<std::uint64_t>(length));
+}
+// 只检查头部本身，limb是否完整由调用方检查
+auto read_header(const std::byte *in) -> header {
+  if (std::memcmp(in, magic, sizeof(magic)) != 0)
+    throw std::invalid_argument{"not a serialized BigInt"};
+  if (load_le<std::uint16_t>(in + 4) != BigInt::serialization_version)
+    throw std::invalid_argument{"unsupported BigInt serialization version"};
+  const auto flags = load_le<std::uint16_t>(in + 6);
+  const auto length = load_le<std::uint64_t>(in + 8);
+  if ((flags & ~negative_flag) != 0 || length == 0 ||
+      length > (std::numeric_limits<size_type>::max() - header_size) /
+                   sizeof(limb_t))
+    throw std::invalid_argument{"corrupted BigInt header"};
+  return {(flags & negative_flag) != 0, static_cast<size_type>(length)};
+}
+// 写入时已经规范化：最高limb不为0，0没有符号
+auto check_normalized(const header &h, const limb_t *limbs) -> void {
+  const bool zero = h.length == 1 && limbs[0] == 0;
+  if ((h.length > 1 && limbs[h.length - 1] == 0) || (zero && h.negative))
+    throw std::invalid_argument{"corrupted BigInt limbs"};
+}
+auto check_complete(std::span<const std::byte> bytes) -> header {
+  if (bytes.size() < header_size)
+    throw std::invalid_argument{"truncated BigInt header"};
+  const header h = read_header(bytes.data());
+  if ((bytes.size() - header_size) / sizeof(limb_t) < h.length)
+    throw std::invalid_argument{"truncated BigInt limbs"};
+  return h;
+}
+} // namespace
+
+auto BigInt::serialized_size() const noexcept -> size_type {
+  return header_size + length_ * sizeof(value_type);
+}
+auto BigInt::serialize(std::span<std::byte> out) const -> size_type {
+  const size_type size = serialized_size();
+  if (out.size() < size)
+    throw std::invalid_argument{"serialization buffer too small"};
+  write_header(out.data(), negative_, length_);
+  std::byte *limbs = out.data() + header_size;
+  if constexpr (native_limbs)
+    std::memcpy(limbs, array_, length_ * sizeof(value_type));
+  else
+    for (size_type i = 0; i < length_; i++)
+      store_le(limbs + i * sizeof(value_type), array_[i]);
+  return size;
+}
+auto BigInt::save(std::ostream &out) const -> void {
+  std::byte head[header_size];
+  write_header(head, negative_, length_);
+  out.write(reinterpret_cast<const char *>(head), header_size);
+  if constexpr (native_limbs) {
+    out.write(reinterpret_cast<const char *>(array_),
+              static_cast<std::streamsize>(length_ * sizeof(value_type)));
+  } else {
+    for (size_type i = 0; i < length_; i++) {
+      std::byte limb[sizeof(value_type)];
+      store_le(limb, array_[i]);
+      out.write(reinterpret_cast<const char *>(limb), sizeof(limb));
+    }
+  }
+}
+auto BigInt::deserialize(std::span<const std::byte> bytes) -> BigInt {
+  const header h = check_complete(bytes);
+  BigInt result{0, h.length};
+  const std::byte *limbs = bytes.data() + header_size;
+  if constexpr (native_limbs)
+    std::memcpy(result.array_, limbs, h.length * sizeof(value_type));
+  else
+    for (size_type i = 0; i < h.length; i++)
+      result.array_[i] = load_le<value_type>(limbs + i * sizeof(value_type));
+  check_normalized(h, result.array_);
+  result.length_ = h.length;
+  result.negative_ = h.negative;
+  return result;
+}
+auto BigInt::load(std::istream &in) -> BigInt {
+  std::byte head[header_size];
+  if (!in.read(reinterpret_cast<char *>(head), header_size))
+    throw std::invalid_argument{"truncated BigInt header"};
+  const header h = read_header(head);
+  // 长度来自不可信的头部，不能按它一次分配；分块直接读入结果的数组，
+  // 每块之前再扩容，分配的空间不超过已读到数据的两倍，不完整时由流报告
+  BigInt result{0, std::min(h.length, load_chunk_limbs)};
+  for (size_type done = 0; done < h.length;) {
+    const size_type n = std::min(load_chunk_limbs, h.length - done);
+    result.reserve(done + n);
+    if (!in.read(reinterpret_cast<char *>(result.array_ + done),
+                 static_cast<std::streamsize>(n * sizeof(value_type))))
+      throw std::invalid_argument{"truncated BigInt limbs"};
+    done += n;
+    result.length_ = done;
+  }
+  if constexpr (!native_limbs)
+    for (size_type i = 0; i < h.length; i++)
+      result.array_[i] = load_le<value_type>(
+          reinterpret_cast<const std::byte *>(result.array_ + i));
+  check_normalized(h, result.array_);
+  result.length_ = h.length;
+  result.negative_ = h.negative;
+  return result;
+}
+
+BigInt::BigInt(const BigIntView &N) : BigInt{0, N.limbs().size()} {
+  std::memcpy(array_, N.limbs().data(), N.limbs().size() * sizeof(value_type));
+  length_ = N.limbs().size();
+  negative_ = N.is_negative();
+}
+auto BigInt::operator+=(const BigIntView &N) -> BigInt & {
+  add_in_place(N.limbs().data(), N.limbs().size(), N.is_negative());
+  return *this;
+}
+auto BigInt::operator-=(const BigIntView &N) -> BigInt & {
+  add_in_place(N.limbs().data(), N.limbs().size(), !N.is_negative());
+  return *this;
+}
+auto BigInt::operator*=(const BigIntView &N) -> BigInt & {
+  mul_in_place(N.limbs().data(), N.limbs().size(), N.is_negative());
+  return *this;
+}
+
+BigIntView::BigIntView(std::span<const std::byte> bytes) {
+  if constexpr (!native_limbs)
+    throw std::runtime_error{"BigIntView requires a little-endian machine"};
+  const header h = check_complete(bytes);
+  const std::byte *limbs = bytes.data() + header_size;
+  if (reinterpret_cast<std::uintptr_t>(limbs) % alignof(value_type) != 0)
+    throw std::invalid_argument{"serialized BigInt limbs are misaligned"};
+  limbs_ = reinterpret_cast<const value_type *>(limbs);
+  length_ = h.length;
+  negative_ = h.negative;
+  check_normalized(h, limbs_);
+}
+auto operator<=>(const BigIntView &A, const BigIntView &B) noexcept
+    -> std::strong_ordering {
+  if (A.negative_ != B.negative_)
+    return A.negative_ ? std::strong_ordering::less
+                       : std::strong_ordering::greater;
+  // 规范化后limb数多的绝对值大
+  int result = A.length_ == B.length_ ? cmp_n(A.limbs_, B.limbs_, A.length_)
+               : A.length_ < B.length_ ? -1
+                                       : 1;
+  if (A.negative_)
+    result = -result;
+  return result <=> 0;
+}
+
+BigInt::mapped_file::mapped_file(const std::filesystem::path &path) {
+#ifdef MY_BIGINT_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    throw std::runtime_error{"can't open " + path.string()};
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error{"can't stat " + path.string()};
+  }
+  size_ = static_cast<size_type>(info.st_size);
+  if (size_) {
+    void *mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error{"can't map " + path.string()};
+    }
+    data_ = static_cast<const std::byte *>(mapping);
+  }
+  // 映射建立后不再需要文件描述符
+  ::close(fd);
+#else
+  std::ifstream in{path, std::ios::binary | std::ios::ate};
+  if (!in)
+    throw std::runtime_error{"can't open " + path.string()};
+  size_ = static_cast<size_type>(in.tellg());
+  buffer_ = std::make_unique_for_overwrite<std::byte[]>(size_);
+  in.seekg(0);
+  if (!in.read(reinterpret_cast<char *>(buffer_.get()),
+               static_cast<std::streamsize>(size_)))
+    throw std::runtime_error{"can't read " + path.string()};
+  data_ = buffer_.get();
+#endif
+}
+BigInt::mapped_file::~mapped_file() {
+#ifdef MY_BIGINT_MMAP
+  if (data_ && !buffer_)
+    ::munmap(const_cast<std::byte *>(data_), size_);
+#endif
+}
+BigInt::mapped_file::mapped_file(mapped_file &&other) noexcept
+    : data_{std::exchange(other.data_, nullptr)},
+      size_{std::exchange(other.size_, 0)}, buffer_{std::move(other.buffer_)} {}
+auto BigInt::mapped_file::operator=(mapped_file &&other) noexcept
+    -> mapped_file & {
+  if (this != &other) {
+    mapped_file old{std::move(*this)};
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+  }
+  return *this;
+}
+auto BigInt::mapped_file::view(size_type offset) const -> BigIntView {
+  if (offset > size_)
+    throw std::out_of_range{"offset past the end of the mapped file"};
+  return BigIntView{bytes().subspan(offset)};
+}
@@ -0,0 +1,225 @@
+// my_bigint_simd.cpp
+// limb加减和比较的AVX2、AVX-512实现，运行时按CPUID选择
+// 每组limb先并行相加，再把组内的进位当作位掩码做一次整数加法一起传递
+#include "my_bigint.h"
+#include "my_bigint_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MY_BIGINT_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+using namespace my_bigint_detail;
+namespace {
+constexpr simd_kernels scalar_kernels{
+    [](limb_t *r, const limb_t *a, const limb_t *b, size_type n) -> limb_t {
+      return add_n_scalar(r, a, b, n);
+    },
+    [](limb_t *r, const limb_t *a, const limb_t *b, size_type n) -> limb_t {
+      return sub_n_scalar(r, a, b, n);
+    },
+    cmp_n_scalar};
+
+#ifdef MY_BIGINT_X86_SIMD
+// 组内第i个limb的进位：g为本位产生进位，p为本位全1、收到进位会继续传递
+// 把(g<<1|carry)加到p上，进位沿连续的p传递，异或p即得到每个limb收到的进位
+// lanes个limb一组，返回值的第lanes位是整组的进位
+constexpr auto carry_lanes(unsigned g, unsigned p, unsigned carry) -> unsigned {
+  return ((g << 1) | carry) + p;
+}
+
+// AVX2没有无符号比较，两边翻转符号位后用有符号比较
+__attribute__((target("avx2"))) auto add_avx2(limb_t *r, const limb_t *a,
+                                              const limb_t *b, size_type n)
+    -> limb_t {
+  const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+  const __m256i ones = _mm256_set1_epi32(-1);
+  const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  unsigned carry = 0;
+  size_type i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    const __m256i y =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    __m256i sum = _mm256_add_epi32(x, y);
+    // sum < x说明本位溢出
+    const auto g = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(
+        _mm256_cmpgt_epi32(_mm256_xor_si256(x, sign),
+                           _mm256_xor_si256(sum, sign)))));
+    const auto p = static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(sum, ones))));
+    const unsigned t = carry_lanes(g, p, carry);
+    // 把收到进位的掩码展开成每个limb的全1，减去-1即加1
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>((t ^ p) & 0xFFU));
+    sum = _mm256_sub_epi32(
+        sum, _mm256_cmpeq_epi32(_mm256_and_si256(mask, lane_bits), lane_bits));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), sum);
+    carry = t >> 8;
+  }
+  return add_n_scalar(r + i, a + i, b + i, n - i, carry);
+}
+__attribute__((target("avx2"))) auto sub_avx2(limb_t *r, const limb_t *a,
+                                              const limb_t *b, size_type n)
+    -> limb_t {
+  const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  unsigned borrow = 0;
+  size_type i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    const __m256i y =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    __m256i difference = _mm256_sub_epi32(x, y);
+    // x < y产生借位，差为0时收到借位会继续向高位借
+    const auto g = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(
+        _mm256_cmpgt_epi32(_mm256_xor_si256(y, sign),
+                           _mm256_xor_si256(x, sign)))));
+    const auto p = static_cast<unsigned>(_mm256_movemask_ps(
+        _mm256_castsi256_ps(_mm256_cmpeq_epi32(difference, zero))));
+    const unsigned t = carry_lanes(g, p, borrow);
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>((t ^ p) & 0xFFU));
+    difference = _mm256_add_epi32(
+        difference,
+        _mm256_cmpeq_epi32(_mm256_and_si256(mask, lane_bits), lane_bits));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + i), difference);
+    borrow = t >> 8;
+  }
+  return sub_n_scalar(r + i, a + i, b + i, n - i, borrow);
+}
+// 从高位开始按组比较，找到第一个不相等的组后再定位到limb
+__attribute__((target("avx2"))) auto cmp_avx2(const limb_t *a, const limb_t *b,
+                                              size_type n) -> int {
+  size_type i = n;
+  for (; i >= 8; i -= 8) {
+    const __m256i x =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i - 8));
+    const __m256i y =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i - 8));
+    const auto equal = static_cast<unsigned>(
+        _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, y))));
+    if (equal != 0xFFU) {
+      const size_type j = i - 8 + std::bit_width(~equal & 0xFFU) - 1;
+      return a[j] < b[j] ? -1 : 1;
+    }
+  }
+  return cmp_n_scalar(a, b, i);
+}
+
+// AVX-512直接得到比较结果的位掩码，带掩码的加减一步完成进位
+__attribute__((target("avx512f"))) auto add_avx512(limb_t *r, const limb_t *a,
+                                                   const limb_t *b, size_type n)
+    -> limb_t {
+  const __m512i ones = _mm512_set1_epi32(-1);
+  unsigned carry = 0;
+  size_type i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i x = _mm512_loadu_si512(a + i);
+    const __m512i y = _mm512_loadu_si512(b + i);
+    __m512i sum = _mm512_add_epi32(x, y);
+    const unsigned g = _mm512_cmplt_epu32_mask(sum, x);
+    const unsigned p = _mm512_cmpeq_epi32_mask(sum, ones);
+    const unsigned t = carry_lanes(g, p, carry);
+    sum = _mm512_mask_sub_epi32(sum, static_cast<__mmask16>(t ^ p), sum, ones);
+    _mm512_storeu_si512(r + i, sum);
+    carry = t >> 16;
+  }
+  return add_n_scalar(r + i, a + i, b + i, n - i, carry);
+}
+__attribute__((target("avx512f"))) auto sub_avx512(limb_t *r, const limb_t *a,
+                                                   const limb_t *b, size_type n)
+    -> limb_t {
+  const __m512i ones = _mm512_set1_epi32(-1);
+  const __m512i zero = _mm512_setzero_si512();
+  unsigned borrow = 0;
+  size_type i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i x = _mm512_loadu_si512(a + i);
+    const __m512i y = _mm512_loadu_si512(b + i);
+    __m512i difference = _mm512_sub_epi32(x, y);
+    const unsigned g = _mm512_cmplt_epu32_mask(x, y);
+    const unsigned p = _mm512_cmpeq_epi32_mask(difference, zero);
+    const unsigned t = carry_lanes(g, p, borrow);
+    difference = _mm512_mask_add_epi32(
+        difference, static_cast<__mmask16>(t ^ p), difference, ones);
+    _mm512_storeu_si512(r + i, difference);
+    borrow = t >> 16;
+  }
+  return sub_n_scalar(r + i, a + i, b + i, n - i, borrow);
+}
+__attribute__((target("avx512f"))) auto cmp_avx512(const limb_t *a,
+                                                   const limb_t *b, size_type n)
+    -> int {
+  size_type i = n;
+  for (; i >= 16; i -= 16) {
+    const unsigned different = _mm512_cmpneq_epi32_mask(
+        _mm512_loadu_si512(a + i - 16), _mm512_loadu_si512(b + i - 16));
+    if (different) {
+      const size_type j = i - 16 + std::bit_width(different) - 1;
+      return a[j] < b[j] ? -1 : 1;
+    }
+  }
+  return cmp_n_scalar(a, b, i);
+}
+
+constexpr simd_kernels avx2_kernels{add_avx2, sub_avx2, cmp_avx2};
+constexpr simd_kernels avx512_kernels{add_avx512, sub_avx512, cmp_avx512};
+#endif
+
+auto detect_simd_level() noexcept -> BigInt::simd_level {
+#ifdef MY_BIGINT_X86_SIMD
+  // 可能在其他静态初始化之前调用，先初始化CPU信息
+  // __builtin_cpu_supports同时检查操作系统是否保存了对应的寄存器状态
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return BigInt::simd_level::avx512;
+  if (__builtin_cpu_supports("avx2"))
+    return BigInt::simd_level::avx2;
+#endif
+  return BigInt::simd_level::scalar;
+}
+auto kernels_for(BigInt::simd_level level) noexcept -> const simd_kernels * {
+#ifdef MY_BIGINT_X86_SIMD
+  switch (level) {
+  case BigInt::simd_level::avx512:
+    return &avx512_kernels;
+  case BigInt::simd_level::avx2:
+    return &avx2_kernels;
+  case BigInt::simd_level::scalar:
+    break;
+  }
+#endif
+  (void)level;
+  return &scalar_kernels;
+}
+} // namespace
+
+// 常量初始化，其他编译单元的静态初始化先用到时也是有效的标量实现
+constinit std::atomic<const simd_kernels *>
+    my_bigint_detail::active_simd_kernels{&scalar_kernels};
+namespace {
+const BigInt::simd_level initial_simd_level =
+    BigInt::set_simd_level(BigInt::max_simd_level());
+} // namespace
+
+auto BigInt::max_simd_level() noexcept -> simd_level {
+  static const simd_level level = detect_simd_level();
+  return level;
+}
+auto BigInt::get_simd_level() noexcept -> simd_level {
+  const simd_kernels *kernels = active_simd_kernels.load();
+  for (const simd_level level : {simd_level::avx512, simd_level::avx2})
+    if (kernels == kernels_for(level))
+      return level;
+  return simd_level::scalar;
+}
+auto BigInt::set_simd_level(simd_level level) noexcept -> simd_level {
+  level = std::min(level, max_simd_level());
+  active_simd_kernels.store(kernels_for(level));
+  return level;
+}
@@ -1,7 +1,20 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest/doctest.h"
 #include "my_bigint.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 auto PI(int) -> BigInt;
 
@@ -147,6 +160,25 @@ TEST_CASE("BigInt and basic integer division tests") {
   }
 }
 
+TEST_CASE("BigInt and basic integer comparison tests") {
+  const BigInt a{"-12345678901234567890"}, b{INT64_MIN};
+  CHECK(a < 0);
+  CHECK(0 > a);
+  CHECK(a < INT64_MIN);
+  CHECK(b == INT64_MIN);
+  CHECK(INT64_MIN == b);
+  CHECK(b != INT64_MAX);
+  CHECK(-b == 9223372036854775808ULL);
+  CHECK(-b > INT64_MAX);
+  CHECK(BigInt{0} == 0U);
+  CHECK(BigInt{0} >= -1);
+  CHECK(BigInt{UINT64_MAX} + 1 > UINT64_MAX);
+  CHECK(BigInt{UINT64_MAX} * UINT64_MAX ==
+        BigInt{"340282366920938463426481119284349108225"});
+  CHECK(INT64_MIN - b == 0);
+  CHECK(5 - BigInt{UINT64_MAX} == BigInt{"-18446744073709551610"});
+  CHECK(-7 * a == BigInt{"86419752308641975230"});
+}
 TEST_CASE("old test") {
   BigInt n1(7654321);
   BigInt n2(7891234);
@@ -192,6 +224,128 @@ TEST_CASE("Addition edge cases") {
             BigInt{"-99999999999999999999999999999"} ==
         BigInt{"-1000000000000000000000000000010000000000"});
 }
+TEST_CASE("compound assignment") {
+  BigInt a{"123456789012345678901234567890"};
+  a += BigInt{"-123456789012345678901234567891"};
+  CHECK(a == BigInt{-1});
+  a -= -1;
+  CHECK(a == BigInt{0});
+  a -= BigInt{"99999999999999999999"};
+  CHECK(a == BigInt{"-99999999999999999999"});
+  a *= -3;
+  CHECK(a == BigInt{"299999999999999999997"});
+  a /= 1000;
+  CHECK(a == BigInt{"299999999999999999"});
+  a %= -1000;
+  CHECK(a == BigInt{999});
+  BigInt b{INT64_MIN};
+  b += INT64_MIN;
+  CHECK(b == BigInt{"-18446744073709551616"});
+  b *= UINT64_MAX;
+  CHECK(b == BigInt{"-340282366920938463444927863358058659840"});
+  b /= INT64_MIN;
+  CHECK(b == BigInt{UINT64_MAX} * 2);
+  SUBCASE("self assignment") {
+    BigInt c{"-98765432109876543210"};
+    c += c;
+    CHECK(c == BigInt{"-197530864219753086420"});
+    c *= c;
+    CHECK(c == BigInt{"39018442319402530102709952751115988416400"});
+    c -= c;
+    CHECK(c == BigInt{0});
+    CHECK(c == -c);
+  }
+}
+TEST_CASE("rvalue operators") {
+  const BigInt a{"-98765432109876543210"}, b{"12345678901234567890"};
+  CHECK((a + b) + (a - b) == a * 2);
+  CHECK(b - (a + b) == -a);
+  CHECK(7 - (a - a) == BigInt{7});
+  CHECK((a * b) * (b * 3) == a * b * b * 3);
+  CHECK(-5 * (b + 1) == BigInt{"-61728394506172839455"});
+  CHECK((a * b) / (b + 0) == a);
+  CHECK((a * b - 17) % b == BigInt{-17});
+  CHECK((a - 1) / -7 == BigInt{"14109347444268077601"});
+  CHECK((a - 1) % -7 == BigInt{-4});
+}
+TEST_CASE("inline storage") {
+  // 128位以内存放在对象内，超出后转到堆上
+  BigInt a{UINT64_MAX};
+  a *= UINT64_MAX;
+  CHECK(a == BigInt{"340282366920938463426481119284349108225"});
+  a += BigInt{"18446744073709551614"};
+  CHECK(a == BigInt{"340282366920938463444927863358058659839"});
+  a += BigInt{"18446744073709551617"};
+  CHECK(a == BigInt{"340282366920938463463374607431768211456"});
+  a -= 1;
+  CHECK(a == BigInt{"340282366920938463463374607431768211455"});
+  SUBCASE("moved-from objects stay usable") {
+    BigInt small{-42}, large{std::string(100, '9')};
+    BigInt b{std::move(small)}, c{std::move(large)};
+    CHECK(b == BigInt{-42});
+    CHECK(c == BigInt{std::string(100, '9')});
+    CHECK(small == BigInt{0});
+    CHECK(large == BigInt{0});
+    small += 7;
+    large = std::move(b);
+    CHECK(small == BigInt{7});
+    CHECK(large == BigInt{-42});
+    c = std::move(large);
+    CHECK(c == BigInt{-42});
+  }
+}
+// 统计分配情况的内存资源
+class counting_resource final : public std::pmr::memory_resource {
+public:
+  std::size_t allocations = 0, outstanding = 0;
+
+private:
+  auto do_allocate(std::size_t bytes, std::size_t alignment) -> void * override {
+    ++allocations;
+    ++outstanding;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  auto do_deallocate(void *p, std::size_t bytes, std::size_t alignment)
+      -> void override {
+    --outstanding;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  auto do_is_equal(const std::pmr::memory_resource &other) const noexcept
+      -> bool override {
+    return this == &other;
+  }
+};
+TEST_CASE("memory resource") {
+  const BigInt sevens{std::string(200, '7')};
+  counting_resource counter;
+  BigInt kept;
+  {
+    const BigInt::resource_scope scope{&counter};
+    BigInt a{sevens};
+    a *= a;
+    CHECK(a.get_resource() == &counter);
+    // 资源不同，移动赋值复制到kept自己的资源上
+    kept = std::move(a);
+  }
+  CHECK(counter.allocations > 0);
+  CHECK(counter.outstanding == 0);
+  CHECK(kept.get_resource() == BigInt::default_resource());
+  CHECK(kept == sevens * sevens);
+  SUBCASE("arena") {
+    BigInt expected{1}, result;
+    for (int i = 2; i <= 300; i++)
+      expected *= i;
+    {
+      const BigInt::arena arena;
+      BigInt x{1};
+      for (int i = 2; i <= 300; i++)
+        x *= i;
+      CHECK(x.to_string() == expected.to_string());
+      result = std::move(x);
+    }
+    CHECK(result == expected);
+  }
+}
 TEST_CASE("pow_of_ten") {
   BigInt a{54378};
   CHECK(a.pow_of_ten(10) == BigInt{54378'00000'00000});
@@ -223,6 +377,22 @@ TEST_CASE("divide integer") {
     CHECK_THROWS_AS(a / c, std::invalid_argument);
   }
 }
+TEST_CASE("divmod_small") {
+  BigInt a{"-123456789012345678901234567890"};
+  CHECK(a.divmod_small(-25) == -15);
+  CHECK(a == BigInt{"4938271560493827156049382715"});
+  CHECK(a.divmod_small(INT64_MIN) == 3883767844221209915);
+  CHECK(a == BigInt{-535408475});
+  BigInt b{"340282366920938463463374607431768211455"};
+  CHECK(b.divmod_small(UINT64_MAX - 1) == 3U);
+  CHECK(b == BigInt{"18446744073709551618"});
+  CHECK(b.divmod_small(UINT64_MAX) == 3U);
+  CHECK(b == 1);
+  CHECK_THROWS_AS(b.divmod_small(0), std::invalid_argument);
+  BigInt c{"-18446744073709551617"};
+  c %= 9223372036854775807LL;
+  CHECK(c == -3);
+}
 TEST_CASE("divide Bigint") {
   BigInt a{12341234};
 
@@ -253,6 +423,722 @@ TEST_CASE("mod integer") {
   CHECK((-a) % (-b) == BigInt{"-3"});
   CHECK(a % -b == BigInt{"3"});
 }
+TEST_CASE("divide large BigInt") {
+  SUBCASE("add back") {
+    // 试商偏大需要加回除数的情形
+    const BigInt a{"170141183420855150474555134919112130560"},
+        b{"39614081257132168796771975169"};
+    CHECK(a / b == BigInt{4294967294U});
+    CHECK(a % b == BigInt{"39614081257132168792477007874"});
+    const BigInt c{"2596148429267413814546714551386112"},
+        d{"604462909807314587418623"};
+    CHECK(c / d == BigInt{4294967295U});
+    CHECK(c % d == BigInt{"604462909807310292451327"});
+  }
+  SUBCASE("quotient and remainder") {
+    BigInt a{std::string(3000, '8')}, b{std::string(1100, '3')};
+    a = a * 7 + 1;
+    b = b * 11 + 4;
+    for (const auto &[x, y] : {std::pair{a, b}, std::pair{-a, b},
+                               std::pair{a, -b}, std::pair{-a, -b}}) {
+      const BigInt q{x / y}, r{x % y};
+      CHECK(q * y + r == x);
+      CHECK(BigInt::abs(r) < BigInt::abs(y));
+      CHECK((r == BigInt{0} || (r < BigInt{0}) == (x < BigInt{0})));
+    }
+    // (10^2n - 1) / (10^n - 1) = 10^n + 1
+    CHECK(BigInt{std::string(2000, '9')} / BigInt{std::string(1000, '9')} ==
+          BigInt{"1" + std::string(999, '0') + "1"});
+  }
+  SUBCASE("divisor longer than twice the quotient") {
+    // 除数约400个limb，商约100个limb，都超过递归除法阈值，按除数截断后试商；
+    // 除数低300个limb全为1，余数接近除数时截断后的试商偏大，余数为负，需要向下修正
+    // 由构造得到确定的商和余数，与算法D的结果相同
+    const BigInt b{(pow(BigInt{3}, 2000) << 9600) + ((BigInt{1} << 9600) - 1)};
+    const BigInt q{pow(BigInt{7}, 1200)};
+    for (const BigInt &r : {BigInt{0}, BigInt{1}, b / 3, b - 1}) {
+      const BigInt a{q * b + r};
+      for (const auto &[x, y, sign] :
+           {std::tuple{a, b, 1}, std::tuple{-a, b, -1},
+            std::tuple{a, -b, -1}, std::tuple{-a, -b, 1}}) {
+        const BigInt expected_q{sign < 0 ? -q : q};
+        const BigInt expected_r{x < BigInt{0} ? -r : r};
+        CHECK(x / y == expected_q);
+        CHECK(x % y == expected_r);
+        CHECK((x / y) * y + x % y == x);
+      }
+    }
+  }
+  SUBCASE("recursive division") {
+    // 除数和商都超过递归除法阈值，商远长于除数时分块
+    const BigInt c{BigInt{std::string(20000, '6')} * 3 + 2},
+        d{BigInt{std::string(1500, '4')} * 9 + 5};
+    const BigInt q{c / d}, r{c % d};
+    CHECK(q * d + r == c);
+    CHECK(BigInt{0} <= r);
+    CHECK(r < d);
+  }
+}
+TEST_CASE("multiply large BigInt") {
+  // (10^n-1)^2 = 10^2n - 2*10^n + 1，覆盖Karatsuba和Toom-3
+  for (std::size_t n : {50, 400, 3000, 12000}) {
+    const BigInt nines{std::string(n, '9')};
+    const std::string expected =
+        std::string(n - 1, '9') + "8" + std::string(n - 1, '0') + "1";
+    CHECK(nines * nines == BigInt{expected});
+    CHECK(nines * -nines == BigInt{"-" + expected});
+  }
+  SUBCASE("NTT") {
+    // 超过一万个limb后走NTT
+    const std::size_t n = 110000;
+    const BigInt nines{std::string(n, '9')};
+    CHECK(nines * nines == BigInt{std::string(n - 1, '9') + "8" +
+                                  std::string(n - 1, '0') + "1"});
+  }
+  SUBCASE("unbalanced operands") {
+    // (10^n-1)*(10^m-1) = 10^(n+m) - 10^n - 10^m + 1
+    const std::size_t n = 9000, m = 700;
+    const BigInt a{std::string(n, '9')}, b{std::string(m, '9')};
+    const std::string expected = std::string(m - 1, '9') + "8" +
+                                 std::string(n - m, '9') +
+                                 std::string(m - 1, '0') + "1";
+    CHECK(a * b == BigInt{expected});
+    CHECK(b * a == BigInt{expected});
+  }
+  SUBCASE("distributive") {
+    BigInt a{std::string(5000, '7')}, b{std::string(4000, '3')},
+        c{std::string(3500, '1')};
+    a = a * 13 + 5;
+    b = b * 11 - 9;
+    CHECK(a * (b + c) == a * b + a * c);
+    CHECK((a - c) * (a + c) == a * a - c * c);
+  }
+}
+TEST_CASE("simd kernels") {
+  // 进位和借位跨越整组limb，各级向量化实现与标量实现结果一致
+  const BigInt full{pow(BigInt{2}, 32 * 100)};
+  const BigInt ones{full - 1};
+  BigInt a{std::string(1000, '7')}, b{std::string(990, '3')};
+  a = a * 12345 + ones;
+  b = b * 54321 - ones;
+  const BigInt::simd_level previous{BigInt::get_simd_level()};
+  BigInt::set_simd_level(BigInt::simd_level::scalar);
+  CHECK(BigInt::get_simd_level() == BigInt::simd_level::scalar);
+  const BigInt sum{a + b}, difference{a - b}, reversed{b - a};
+  for (const auto level :
+       {BigInt::simd_level::scalar, BigInt::simd_level::avx2,
+        BigInt::simd_level::avx512}) {
+    CAPTURE(static_cast<int>(level));
+    if (BigInt::set_simd_level(level) != level)
+      continue;
+    CHECK(ones + 1 == full);
+    CHECK(full - 1 == ones);
+    CHECK(full - ones == 1);
+    CHECK(a + b == sum);
+    CHECK(a - b == difference);
+    CHECK(b - a == reversed);
+    CHECK(a - b + b == a);
+    CHECK(ones < full);
+    CHECK_FALSE(full < ones);
+    CHECK(a + 1 > a);
+    CHECK(a * 2 - a == a);
+  }
+  CHECK(BigInt::set_simd_level(BigInt::simd_level::avx512) ==
+        BigInt::max_simd_level());
+  BigInt::set_simd_level(previous);
+}
+TEST_CASE("parallel") {
+  // 阈值调低，让Karatsuba、Toom-3、分块乘法、NTT和递归除法都经过线程池
+  std::vector<BigInt> numbers;
+  for (std::size_t n : {800, 6000, 30000, 200000}) {
+    BigInt x{std::string(n, '6')};
+    numbers.push_back(x * 7 + 1);
+  }
+  std::vector<BigInt> expected;
+  for (const BigInt &x : numbers)
+    for (const BigInt &y : numbers) {
+      expected.push_back(x * y);
+      expected.push_back(x / (y + 3));
+    }
+  BigInt::set_parallel(4, 64);
+  CHECK(BigInt::parallel_threads() == 4);
+  std::size_t i = 0;
+  for (const BigInt &x : numbers)
+    for (const BigInt &y : numbers) {
+      CHECK(x * y == expected[i++]);
+      CHECK(x / (y + 3) == expected[i++]);
+    }
+  for (const BigInt &x : numbers)
+    CHECK(x.square() == x * BigInt{x});
+  SUBCASE("arena") {
+    const BigInt::arena arena;
+    BigInt x{numbers[2]};
+    x *= numbers[1];
+    CHECK(x == numbers[2] * numbers[1]);
+  }
+  BigInt::set_parallel(1);
+  CHECK(BigInt::parallel_threads() == 1);
+}
+TEST_CASE("square and pow") {
+  // 平方和普通乘法结果一致，覆盖各级平方算法
+  for (std::size_t n : {30, 60, 500, 4000, 110000}) {
+    BigInt a{std::string(n, '8')};
+    a = a * 7 + 3;
+    const BigInt b{a};
+    CHECK(a.square() == a * b);
+    CHECK((-a).square() == a * b);
+  }
+  CHECK(BigInt{}.square() == 0);
+  CHECK(BigInt{-3}.square() == 9);
+
+  BigInt expected{1};
+  for (int i = 0; i < 1000; i++)
+    expected *= 3;
+  CHECK(pow(BigInt{3}, 1000) == expected);
+  CHECK(pow(BigInt{-3}, 1001) == expected * -3);
+  CHECK(pow(BigInt{"123456789123456789"}, 0) == 1);
+  CHECK(pow(BigInt{0}, 5) == 0);
+  CHECK(pow(BigInt{2}, 200) == BigInt{"1606938044258990275541962092341162602"
+                                      "522202993782792835301376"});
+}
+TEST_CASE("powmod") {
+  // 梅森素数，费马小定理 a^(p-1) ≡ 1 (mod p)
+  const BigInt m521{pow(BigInt{2}, 521) - 1};
+  CHECK(BigInt::powmod(BigInt{3}, m521 - 1, m521) == 1);
+  CHECK(BigInt::powmod(BigInt{3}, m521, m521) == 3);
+  // 超过Montgomery阈值的奇数模数和偶数模数走Barrett约简
+  const BigInt m4423{pow(BigInt{2}, 4423) - 1};
+  const BigInt::modular_context large{m4423};
+  CHECK_FALSE(large.is_montgomery());
+  CHECK(large.pow(BigInt{5}, m4423 - 1) == 1);
+  const BigInt::modular_context even{pow(BigInt{10}, 50)};
+  CHECK_FALSE(even.is_montgomery());
+  CHECK(even.pow(BigInt{2}, pow(BigInt{10}, 30)) ==
+        BigInt{"40282316652966971955893380022607743740081787109376"});
+
+  const BigInt::modular_context ctx{pow(BigInt{10}, 40) + 1};
+  CHECK(ctx.is_montgomery());
+  CHECK(ctx.pow(BigInt{-7}, BigInt{"12345678901234567890"}) ==
+        BigInt{"5043617643289198646155130596158221021404"});
+  CHECK(BigInt::powmod(BigInt{123456789}, BigInt{987654321},
+                       pow(BigInt{2}, 127) - 1) ==
+        BigInt{"54332918125842946475806989909357123968"});
+  CHECK(ctx.reduce(BigInt{-1}) == pow(BigInt{10}, 40));
+  CHECK(ctx.mul(BigInt{-1}, BigInt{-1}) == 1);
+  CHECK(ctx.pow(BigInt{12345}, BigInt{0}) == 1);
+  CHECK(ctx.pow(BigInt{0}, BigInt{7}) == 0);
+  CHECK(BigInt::powmod(BigInt{12345}, BigInt{6789}, BigInt{1}) == 0);
+  CHECK_THROWS_AS(BigInt::powmod(BigInt{2}, BigInt{-1}, BigInt{7}),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(BigInt::modular_context{BigInt{0}}, std::invalid_argument);
+}
+TEST_CASE("statistics") {
+  using operation = BigInt::operation;
+  const BigInt a{std::string(3000, '7')}, b{std::string(2000, '3')};
+  BigInt::reset_statistics();
+  const BigInt product{a * b};
+  BigInt quotient{product};
+  quotient /= b;
+  CHECK(quotient == a);
+  const BigInt::statistics stats{BigInt::thread_statistics()};
+  if constexpr (BigInt::instrumented) {
+    // 内部的构造、加法不单独计数，分配计入外层运算
+    CHECK(stats[operation::multiply].calls == 1);
+    CHECK(stats[operation::multiply].allocations >= 1);
+    CHECK(stats[operation::divide].calls == 1);
+    CHECK(stats[operation::construct].calls == 1);
+    CHECK(stats[operation::construct].copies == 1);
+    CHECK(stats[operation::add].calls == 0);
+    // 3000位约为312个limb，落在[256, 512)
+    CHECK(stats[operation::multiply].limb_histogram[8] == 1);
+    BigInt::statistics total{BigInt::global_statistics()};
+    CHECK(total[operation::multiply].calls >= 1);
+    total += stats;
+    CHECK(total[operation::multiply].calls >= 2);
+  } else {
+    CHECK(stats[operation::multiply].calls == 0);
+    CHECK(BigInt::global_statistics()[operation::construct].calls == 0);
+  }
+  std::ostringstream out;
+  out << stats;
+  CHECK(out.str().find("multiply: calls=") != std::string::npos);
+}
+TEST_CASE("binary serialization") {
+  const std::vector<BigInt> numbers{
+      BigInt{0}, BigInt{-1}, BigInt{"4294967296"},
+      -pow(BigInt{3}, 5000), BigInt{std::string(20000, '9')}};
+  std::stringstream stream;
+  for (const BigInt &x : numbers) {
+    std::vector<std::byte> bytes(x.serialized_size());
+    CHECK(x.serialize(bytes) == bytes.size());
+    CHECK(BigInt::deserialize(bytes) == x);
+    x.save(stream);
+  }
+  // 连续存放的多个数依次读出
+  for (const BigInt &x : numbers)
+    CHECK(BigInt::load(stream) == x);
+  CHECK_THROWS_AS((void)BigInt::load(stream), std::invalid_argument);
+
+  // 头部固定为小端序
+  std::vector<std::byte> bytes(BigInt{-258}.serialized_size());
+  (void)BigInt{-258}.serialize(bytes);
+  CHECK(bytes.size() == 20);
+  CHECK(bytes[0] == std::byte{'B'});
+  CHECK(bytes[4] == std::byte{1});
+  CHECK(bytes[6] == std::byte{1});
+  CHECK(bytes[8] == std::byte{1});
+  CHECK(bytes[16] == std::byte{2});
+  CHECK(bytes[17] == std::byte{1});
+  CHECK_THROWS_AS((void)BigInt::deserialize(std::span{bytes}.first(19)),
+                  std::invalid_argument);
+  bytes[4] = std::byte{2};
+  CHECK_THROWS_AS((void)BigInt::deserialize(bytes), std::invalid_argument);
+  bytes[4] = std::byte{1};
+  // 从流读取时按块读入：跨越多块的数，以及长度字段远大于实际数据的头部
+  const BigInt huge{(BigInt{1} << 2500000) - 1};
+  std::stringstream huge_stream;
+  huge.save(huge_stream);
+  CHECK(BigInt::load(huge_stream) == huge);
+  bytes[8] = std::byte{0};
+  bytes[13] = std::byte{1};
+  std::stringstream oversized{std::string{
+      reinterpret_cast<const char *>(bytes.data()), bytes.size()}};
+  CHECK_THROWS_AS((void)BigInt::load(oversized), std::invalid_argument);
+  bytes[0] = std::byte{'X'};
+  CHECK_THROWS_AS(BigIntView{bytes}, std::invalid_argument);
+
+  SUBCASE("mapped file") {
+    const std::filesystem::path path{std::filesystem::temp_directory_path() /
+                                     "my_bigint_serialization_test.bin"};
+    {
+      std::ofstream out{path, std::ios::binary};
+      for (const BigInt &x : numbers)
+        x.save(out);
+    }
+    {
+      const BigInt::mapped_file file{path};
+      BigInt::size_type offset = 0;
+      for (const BigInt &x : numbers) {
+        const BigIntView view{file.view(offset)};
+        CHECK(view == x);
+        CHECK(BigInt{view} == x);
+        offset += view.serialized_size();
+      }
+      CHECK(offset == file.bytes().size());
+      // 视图直接参与运算
+      const BigIntView big{file.view(numbers[0].serialized_size() +
+                                     numbers[1].serialized_size() +
+                                     numbers[2].serialized_size())};
+      CHECK(big.is_negative());
+      CHECK(big < numbers[1]);
+      BigInt x{7};
+      x *= big;
+      x -= big;
+      CHECK(x == numbers[3] * 6);
+      CHECK(big.to_string() == numbers[3].to_string());
+    }
+    std::filesystem::remove(path);
+    CHECK_THROWS_AS(BigInt::mapped_file{path}, std::runtime_error);
+  }
+}
+TEST_CASE("to_chars and from_chars") {
+  for (const std::string &text :
+       {std::string{"0"}, std::string{"-7"}, std::string{"18446744073709551615"},
+        std::string{"-18446744073709551616"}, std::string{"1"}.append(400, '0'),
+        std::string{"-"}.append(5000, '9'), std::string(30000, '8')}) {
+    const BigInt x{text};
+    // 恰好放得下和差一个字符
+    std::string buffer(text.size(), '#');
+    const auto [end, ec] =
+        to_chars(buffer.data(), buffer.data() + buffer.size(), x);
+    CHECK(ec == std::errc{});
+    CHECK(end == buffer.data() + buffer.size());
+    CHECK(buffer == text);
+    const auto result =
+        to_chars(buffer.data(), buffer.data() + buffer.size() - 1, x);
+    CHECK(result.ec == std::errc::value_too_large);
+    CHECK(result.ptr == buffer.data() + buffer.size() - 1);
+
+    BigInt y{123};
+    const std::string input{text + "x"};
+    const auto [ptr, error] =
+        from_chars(input.data(), input.data() + input.size(), y);
+    CHECK(error == std::errc{});
+    CHECK(ptr == input.data() + text.size());
+    CHECK(y == x);
+  }
+  // 不超过300个limb时to_chars和operator<<都不分配内存
+  const BigInt medium{pow(BigInt{7}, 3000)}, small{std::string(200, '3')};
+  const std::string medium_text{medium.to_string()};
+  counting_resource counter;
+  {
+    const BigInt::resource_scope scope{&counter};
+    std::string buffer(medium_text.size(), '#');
+    CHECK(to_chars(buffer.data(), buffer.data() + buffer.size(), medium).ec ==
+          std::errc{});
+    CHECK(buffer == medium_text);
+    CHECK(to_chars(buffer.data(), buffer.data() + buffer.size() - 1, medium)
+              .ec == std::errc::value_too_large);
+    std::ostringstream out;
+    out << small;
+    CHECK(out.str() == std::string(200, '3'));
+  }
+  CHECK(counter.allocations == 0);
+
+  BigInt z{5};
+  for (const std::string_view bad : {"", "-", "+1", " 1", "x1"}) {
+    const auto [ptr, ec] = from_chars(bad.data(), bad.data() + bad.size(), z);
+    CHECK(ec == std::errc::invalid_argument);
+    CHECK(ptr == bad.data());
+  }
+  CHECK(z == 5);
+  const std::string_view negative_zero{"-000"};
+  (void)from_chars(negative_zero.data(),
+                   negative_zero.data() + negative_zero.size(), z);
+  CHECK(z == 0);
+  CHECK(z.to_string() == "0");
+
+  // 输出仍然支持宽度和填充
+  std::ostringstream out;
+  out << std::setw(6) << std::setfill('*') << BigInt{-42} << ' '
+      << BigInt{"123456789012345678901234567890"};
+  CHECK(out.str() == "***-42 123456789012345678901234567890");
+  const BigInt big{pow(BigInt{7}, 3000)};
+  std::ostringstream big_out;
+  big_out << big;
+  CHECK(big_out.str() == big.to_string());
+#ifdef __cpp_lib_format
+  CHECK(std::format("{:>8}|{}", BigInt{-12}, big) ==
+        "     -12|" + big.to_string());
+#endif
+}
+TEST_CASE("bit operations") {
+  // 与64位有符号整数的移位和按位运算逐个对比
+  const std::int64_t values[] = {0, 1, -1, 5, -6, 0x7FFFFFFF, -0x80000000LL,
+                                 0x123456789ALL, -0x123456789ALL};
+  for (const std::int64_t a : values) {
+    for (const std::int64_t b : values) {
+      CHECK((BigInt{a} & BigInt{b}) == (a & b));
+      CHECK((BigInt{a} | BigInt{b}) == (a | b));
+      CHECK((BigInt{a} ^ BigInt{b}) == (a ^ b));
+    }
+    CHECK(~BigInt{a} == ~a);
+    for (const BigInt::size_type k : {0, 1, 7, 31, 32, 33, 40}) {
+      CHECK((BigInt{a} >> k) == (a >> k));
+      BigInt x{a};
+      x >>= k;
+      CHECK(x == (a >> k));
+      if (k < 20) {
+        CHECK((BigInt{a} << k) == a * (std::int64_t{1} << k));
+        x = a;
+        x <<= k;
+        CHECK(x == a * (std::int64_t{1} << k));
+      }
+    }
+  }
+  CHECK((BigInt{-1} >> 1000) == -1);
+  CHECK((BigInt{1} >> 1000) == 0);
+  const BigInt a{-pow(BigInt{3}, 2000)}, b{pow(BigInt{7}, 1500) + 12345};
+  for (const BigInt::size_type k : {1, 32, 100, 3200}) {
+    CHECK(((a << k) >> k) == a);
+    CHECK((a << k) == a * pow(BigInt{2}, k));
+    // 右移向负无穷取整
+    CHECK((a >> k) == (a - pow(BigInt{2}, k) + 1) / pow(BigInt{2}, k));
+    CHECK((b >> k) == b / pow(BigInt{2}, k));
+  }
+  // 负的移位数反向移位
+  for (const int k : {1, 31, 100}) {
+    CHECK((a << -k) == (a >> k));
+    CHECK((b >> -k) == (b << k));
+    BigInt x{a};
+    x <<= -k;
+    CHECK(x == (a >> k));
+    x >>= -k;
+    CHECK(x == ((a >> k) << k));
+  }
+  CHECK((a << std::numeric_limits<std::intmax_t>::min()) == -1);
+  CHECK((b << std::numeric_limits<std::intmax_t>::min()) == 0);
+  CHECK((a >> std::numeric_limits<std::uintmax_t>::max()) == -1);
+  // limb数超出size_type的左移抛出异常，原值不变
+  CHECK_THROWS_AS((void)(b << std::numeric_limits<std::uintmax_t>::max()),
+                  std::length_error);
+  BigInt y{b};
+  CHECK_THROWS_AS(y <<= std::numeric_limits<std::uintmax_t>::max(),
+                  std::length_error);
+  CHECK(y == b);
+  CHECK((BigInt{0} << std::numeric_limits<std::uintmax_t>::max()) == 0);
+  CHECK((a & b) + (a | b) == a + b);
+  CHECK((a ^ b) == (a | b) - (a & b));
+  CHECK(~~a == a);
+  CHECK((a & -1) == a);
+  CHECK((0xFF & b) == b % 256);
+  BigInt c{b};
+  c ^= b;
+  CHECK(c == 0);
+  c |= 6;
+  c &= 3;
+  CHECK(c == 2);
+}
+TEST_CASE("power of two radix") {
+  const BigInt x{"-0123456789abcdefABCDEF0000000000000000000000001", 16};
+  CHECK(x.to_string(16) == "-123456789abcdefabcdef0000000000000000000000001");
+  CHECK(BigInt{"ff", 16} == 255);
+  CHECK(BigInt{"-101", 2} == -5);
+  CHECK(BigInt{"777", 8} == 511);
+  CHECK(BigInt{"v", 32} == 31);
+  CHECK(BigInt{"0", 16}.to_string(2) == "0");
+  CHECK(BigInt{"-000", 16}.to_string(16) == "0");
+  CHECK(BigInt{4294967296}.to_string(16) == "100000000");
+  CHECK(BigInt{-4294967295}.to_string(8) == "-37777777777");
+  CHECK(BigInt{"123456789"}.to_string(10) == "123456789");
+  const BigInt big{pow(BigInt{3}, 5000) * -7};
+  for (const int base : {2, 4, 8, 16, 32, 10})
+    CHECK(BigInt{big.to_string(base), base} == big);
+  CHECK_THROWS_AS(BigInt("12g", 16), std::invalid_argument);
+  CHECK_THROWS_AS(BigInt("", 16), std::invalid_argument);
+  CHECK_THROWS_AS(BigInt("12", 3), std::invalid_argument);
+  CHECK_THROWS_AS((void)big.to_string(36), std::invalid_argument);
+
+  char buffer[4];
+  CHECK(to_chars(buffer, buffer + 4, BigInt{0xABCD}, 16).ptr == buffer + 4);
+  CHECK(std::string_view{buffer, 4} == "abcd");
+  CHECK(to_chars(buffer, buffer + 4, BigInt{0x10000}, 16).ec ==
+        std::errc::value_too_large);
+  BigInt y;
+  const std::string_view hex{"DeadBeef!"};
+  const auto [ptr, ec] = from_chars(hex.data(), hex.data() + hex.size(), y, 16);
+  CHECK(ec == std::errc{});
+  CHECK(ptr == hex.data() + 8);
+  CHECK(y == 0xDEADBEEF);
+}
+TEST_CASE("gcd") {
+  // 朴素的欧几里得算法作为对照
+  const auto euclid = [](BigInt a, BigInt b) {
+    a = a < 0 ? -a : a;
+    b = b < 0 ? -b : b;
+    while (b != 0) {
+      a %= b;
+      std::swap(a, b);
+    }
+    return a;
+  };
+  CHECK(BigInt::gcd(BigInt{0}, BigInt{0}) == 0);
+  CHECK(BigInt::gcd(BigInt{0}, BigInt{-12}) == 12);
+  CHECK(BigInt::gcd(BigInt{-48}, BigInt{18}) == 6);
+  CHECK(BigInt::gcd(BigInt{"123456789012345678901234567890"},
+                    BigInt{"987654321098765432109876543210"}) ==
+        BigInt{"9000000000900000000090"});
+  // 覆盖二进制GCD、Lehmer和half-GCD，长度相差悬殊时先做除法
+  BigInt x{1};
+  for (int limbs : {1, 2, 3, 5, 40, 130, 300, 700}) {
+    const BigInt a{pow(BigInt{3}, limbs * 20) + x};
+    const BigInt b{pow(BigInt{7}, limbs * 11) - x * 5};
+    x = x * 31 + 17;
+    CHECK(BigInt::gcd(a, b) == euclid(a, b));
+    CHECK(BigInt::gcd(a * b, b * 3) == euclid(a * b, b * 3));
+    CHECK(BigInt::gcd(a * x, -(b * x)) == euclid(a * x, b * x));
+    CHECK(BigInt::gcd(a, BigInt{limbs}) == euclid(a, BigInt{limbs}));
+  }
+  const BigInt g{pow(BigInt{10}, 3000) + 7};
+  CHECK(BigInt::gcd(g * pow(BigInt{2}, 90000), g * pow(BigInt{3}, 60000)) ==
+        g);
+
+  // 扩展欧几里得，x在[0, |b|/g)中
+  for (const auto &[a, b] : std::vector<std::pair<BigInt, BigInt>>{
+           {BigInt{240}, BigInt{46}},
+           {BigInt{-240}, BigInt{46}},
+           {BigInt{240}, BigInt{-46}},
+           {BigInt{7}, BigInt{0}},
+           {BigInt{0}, BigInt{-9}},
+           {BigInt{5}, BigInt{5}},
+           {pow(BigInt{3}, 800) + 1, pow(BigInt{2}, 900) + 3},
+           {pow(BigInt{5}, 9000) * 6, pow(BigInt{7}, 8000) * 4},
+           {pow(BigInt{3}, 40000) + 1, pow(BigInt{2}, 60000) + 3}}) {
+    const BigInt::xgcd_result r{BigInt::xgcd(a, b)};
+    CHECK(r.gcd == BigInt::gcd(a, b));
+    CHECK(a * r.x + b * r.y == r.gcd);
+    if (b != 0) {
+      CHECK(r.x >= 0);
+      CHECK(r.x < (b < 0 ? -b : b) / r.gcd);
+    }
+  }
+
+  const BigInt m{pow(BigInt{2}, 521) - 1};
+  const BigInt inverse{BigInt::modinv(BigInt{-12345}, m)};
+  CHECK(inverse >= 0);
+  CHECK(inverse < m);
+  CHECK((inverse * -12345 % m + m) % m == 1);
+  CHECK(BigInt::modinv(BigInt{3}, BigInt{7}) == 5);
+  CHECK(BigInt::modinv(BigInt{10}, BigInt{1}) == 0);
+  CHECK_THROWS_AS(BigInt::modinv(BigInt{6}, BigInt{9}), std::invalid_argument);
+  CHECK_THROWS_AS(BigInt::modinv(BigInt{3}, BigInt{0}), std::invalid_argument);
+  CHECK_THROWS_AS(BigInt::modinv(BigInt{3}, BigInt{-7}), std::invalid_argument);
+}
+TEST_CASE("integer roots") {
+  CHECK(BigInt::isqrt(BigInt{0}) == 0);
+  CHECK(BigInt::isqrt(BigInt{15}) == 3);
+  CHECK(BigInt::isqrt(BigInt{16}) == 4);
+  CHECK(BigInt::isqrt(BigInt{"18446744073709551615"}) == 4294967295U);
+  CHECK(BigInt::isqrt(BigInt{"18446744073709551616"}) == 4294967296U);
+  // 精度翻倍的每一层都要向下取整，检查平方数及其两侧
+  for (std::size_t e : {40, 200, 3000, 40000}) {
+    const BigInt root{pow(BigInt{3}, e) + 12345};
+    const BigInt square{root.square()};
+    CHECK(BigInt::isqrt(square) == root);
+    CHECK(BigInt::isqrt(square - 1) == root - 1);
+    CHECK(BigInt::isqrt(square + root * 2) == root);
+  }
+  CHECK(BigInt::isqrt(pow(BigInt{10}, 100) * 2) ==
+        BigInt{"141421356237309504880168872420969807856967187537694"});
+
+  CHECK(BigInt::iroot(BigInt{26}, 3) == 2);
+  CHECK(BigInt::iroot(BigInt{27}, 3) == 3);
+  CHECK(BigInt::iroot(BigInt{-28}, 3) == -3);
+  CHECK(BigInt::iroot(BigInt{12345}, 1) == 12345);
+  CHECK(BigInt::iroot(pow(BigInt{10}, 99) * 2, 3) ==
+        BigInt{"1259921049894873164767210607278228"});
+  for (std::size_t k : {3, 5, 7, 64, 1000}) {
+    const BigInt root{pow(BigInt{7}, 4000 / k + 50) + 1};
+    const BigInt power{pow(root, k)};
+    CHECK(BigInt::iroot(power, k) == root);
+    CHECK(BigInt::iroot(power - 1, k) == root - 1);
+    CHECK(BigInt::iroot(power + 1, k) == root);
+  }
+  CHECK_THROWS_AS(BigInt::isqrt(BigInt{-1}), std::invalid_argument);
+  CHECK_THROWS_AS(BigInt::iroot(BigInt{-16}, 4), std::invalid_argument);
+  CHECK_THROWS_AS(BigInt::iroot(BigInt{16}, 0), std::invalid_argument);
+
+  for (const BigInt &n : {BigInt{0}, BigInt{1}, BigInt{-1}, BigInt{4},
+                          BigInt{-8}, BigInt{1024}, pow(BigInt{6}, 35),
+                          pow(BigInt{-12345}, 7), pow(BigInt{2}, 9973),
+                          pow(BigInt{10}, 60) * pow(BigInt{10}, 60),
+                          pow(BigInt{3}, 20000)})
+    CHECK(BigInt::is_perfect_power(n));
+  for (const BigInt &n :
+       {BigInt{2}, BigInt{-4}, BigInt{12}, BigInt{-96}, pow(BigInt{2}, 61) - 1,
+        pow(BigInt{6}, 35) + 1, pow(BigInt{2}, 9973) * 3,
+        pow(BigInt{12345}, 2) * -1, pow(BigInt{3}, 20000) - 1})
+    CHECK_FALSE(BigInt::is_perfect_power(n));
+}
+TEST_CASE("batch sum and product") {
+  CHECK(BigInt::sum({}) == 0);
+  CHECK(BigInt::product({}) == 1);
+  // 长短和正负混合，与逐个相加、相乘的结果比较
+  std::vector<BigInt> values;
+  BigInt x{"987654321987654321"};
+  for (int i = 0; i < 600; i++) {
+    x = x * 1000003 + i;
+    if (i % 50 == 0)
+      values.push_back(pow(x, 40));
+    else if (i % 3 == 0)
+      values.push_back(-x);
+    else
+      values.push_back(BigInt{i + 1});
+  }
+  BigInt expected_sum{0}, expected_product{1};
+  for (const BigInt &v : values) {
+    expected_sum += v;
+    expected_product *= v;
+  }
+  CHECK(BigInt::sum(values) == expected_sum);
+  CHECK(BigInt::product(values) == expected_product);
+  CHECK(BigInt::sum(std::span{values}.first(1)) == values[0]);
+  CHECK(BigInt::product(std::span{values}.subspan(7, 1)) == values[7]);
+  // 全部抵消
+  const std::vector<BigInt> cancel{x, -x, BigInt{-1}, BigInt{1}};
+  CHECK(BigInt::sum(cancel) == 0);
+  const BigInt replaced{std::exchange(values[300], BigInt{0})};
+  CHECK(BigInt::product(values) == 0);
+
+  // 1到5000的乘积与逐个相乘一致
+  std::vector<BigInt> factors;
+  BigInt factorial{1};
+  for (int i = 1; i <= 5000; i++) {
+    factors.push_back(BigInt{i});
+    factorial *= i;
+  }
+  CHECK(BigInt::product(factors) == factorial);
+  BigInt::set_parallel(4, 64);
+  CHECK(BigInt::product(factors) == factorial);
+  values[300] = pow(x, 60);
+  CHECK(BigInt::sum(values) == expected_sum - replaced + values[300]);
+  // 调用方使用arena时，工作线程不能从arena分配，结果仍在调用方的资源上
+  BigInt::set_parallel(4, 8);
+  {
+    BigInt::arena arena;
+    const BigInt total{BigInt::sum(values)}, all{BigInt::product(factors)};
+    CHECK(total == expected_sum - replaced + values[300]);
+    CHECK(all == factorial);
+    CHECK(total.get_resource() == arena.resource());
+    CHECK(all.get_resource() == arena.resource());
+  }
+  BigInt::set_parallel(1);
+}
+TEST_CASE("FixedBigInt") {
+  // 2^127-1，字面量和乘方在编译期得到同一个值
+  constexpr FixedBigInt mersenne{"170141183460469231731687303715884105727"};
+  constexpr auto power = pow(FixedBigInt<8>{2}, 127) - FixedBigInt<1>{1};
+  static_assert(mersenne == power);
+  static_assert(mersenne.limbs().size() == 4);
+  constexpr auto square = mersenne * mersenne;
+  static_assert(square > mersenne && -square < mersenne);
+  static_assert((mersenne - mersenne).is_zero());
+  static_assert(!(FixedBigInt<1>{-5} + FixedBigInt<1>{5}).is_negative());
+  static_assert(FixedBigInt<2>{INT64_MIN} == -FixedBigInt<2>{1ULL << 63});
+
+  // 运行时与BigInt的结果一致，BigInt{c}和BigIntView不经过十进制解析
+  const BigInt m{"170141183460469231731687303715884105727"};
+  CHECK(BigInt{mersenne} == m);
+  CHECK(BigInt{square} == m * m);
+  CHECK(BigIntView{power} == BigIntView{m});
+  CHECK(square.to_string() == (m * m).to_string());
+  BigInt x{m};
+  x -= square;
+  CHECK(x == m - m * m);
+  std::ostringstream out;
+  out << -mersenne;
+  CHECK(out.str() == "-170141183460469231731687303715884105727");
+
+  // 正负混合的加减乘与BigInt比较
+  FixedBigInt<16> a{"-98765432109876543210987654321"};
+  BigInt b{"-98765432109876543210987654321"};
+  const FixedBigInt<3> step{"12345678901234567890123"};
+  const BigInt big_step{"12345678901234567890123"};
+  for (int i = 0; i < 40; i++) {
+    a += step;
+    b += big_step;
+    CHECK(BigInt{a} == b);
+    CHECK(BigInt{a * step} == b * big_step);
+    CHECK(BigInt{a - step * step} == b - big_step * big_step);
+  }
+
+  // 放不下或格式错误时抛出异常，常量表达式中为编译错误
+  CHECK_THROWS_AS(pow(FixedBigInt<2>{10}, 20), std::overflow_error);
+  CHECK_THROWS_AS(FixedBigInt<1>{FixedBigInt<2>{UINT64_MAX}},
+                  std::overflow_error);
+  CHECK(FixedBigInt<1>{FixedBigInt<2>{UINT32_MAX}} ==
+        FixedBigInt<1>{UINT32_MAX});
+  CHECK_THROWS_AS(FixedBigInt<4>{"12a"}, std::invalid_argument);
+  CHECK_THROWS_AS(FixedBigInt<4>{"-"}, std::invalid_argument);
+}
+TEST_CASE("decimal string conversion") {
+  // 超过阈值后分治转换，中间的0块最容易出错
+  for (std::size_t n : {100, 2999, 3001, 20000, 70000}) {
+    const std::string nines(n, '9');
+    CHECK(BigInt{nines}.to_string() == nines);
+    CHECK(BigInt{"-" + nines}.to_string() == "-" + nines);
+    std::string power(n + 1, '0');
+    power[0] = '1';
+    CHECK(BigInt{power}.to_string() == power);
+    CHECK(BigInt{power} == pow(BigInt{10}, static_cast<int>(n)));
+    std::string sparse = power;
+    sparse[n / 3] = '7';
+    sparse[n / 2] = '3';
+    CHECK(BigInt{sparse}.to_string() == sparse);
+  }
+  CHECK(BigInt{std::string(30000, '0') + "12"}.to_string() == "12");
+  CHECK(BigInt{"-" + std::string(30000, '0')}.to_string() == "0");
+}
 TEST_CASE("test pi") {
   CHECK(PI(3) == BigInt{314});
   CHECK(PI(8) == BigInt{"31415926"});